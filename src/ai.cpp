@@ -6,6 +6,20 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <functional>
+
+#include "alloccounter.cpp"
+#include "board.cpp"
+#include "gamelogic.cpp"
+#include "evaluator.cpp"
+#include "lineruns.cpp"
+#include "transposition.cpp"
+#include "threatsearch.cpp"
+#include "openingbook.cpp"
+#include "searchprofile.cpp"
 
 class AI {
 public:
@@ -42,10 +56,77 @@ public:
     struct ThinkingStats {
         int nodesEvaluated;
         int pruningCount;
+        int reducedMoves;                // Nước được search với depth giảm (LMR)
+        int researches;                  // Lần search lại sau khi null window / LMR vượt alpha
         int maxDepthReached;
         double timeElapsed;
+        int ttHits;
+        int ttMisses;
+        int threatNodes;
+        int threatPositionsSolved;
+        int bookHits;
+        long long searchAllocations;     // Số lần cấp phát heap trong negamax (luôn 0 nếu không bật CARO_COUNT_ALLOCATIONS)
+        double nodesPerSecond;
+        double ttHitRate;                // ttHits / (ttHits + ttMisses)
+        double effectiveBranchingFactor; // Node iteration cuối / iteration trước đó (worker chính)
+        SearchProfile profile;           // Pha và branching factor theo ply cần CARO_SEARCH_PROFILE
+        
+        ThinkingStats() : nodesEvaluated(0), pruningCount(0), reducedMoves(0), researches(0),
+                          maxDepthReached(0), timeElapsed(0.0), ttHits(0), ttMisses(0),
+                          threatNodes(0), threatPositionsSolved(0), bookHits(0),
+                          searchAllocations(0), nodesPerSecond(0.0), ttHitRate(0.0),
+                          effectiveBranchingFactor(0.0) {}
+    };
+    
+    /**
+     * Cờ dừng dùng chung giữa caller và search: mọi bản copy trỏ tới cùng một cờ, nên có thể
+     * giữ một bản ở thread khác rồi requestStop() giữa lúc findBestMove đang chạy.
+     * Token chỉ dùng một lần (như std::stop_source): cờ đã bật thì giữ nguyên cho tới reset().
+     */
+    class StopToken {
+    public:
+        StopToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+        
+        void requestStop() const { flag->store(true, std::memory_order_relaxed); }
+        bool stopRequested() const { return flag->load(std::memory_order_relaxed); }
+        void reset() const { flag->store(false, std::memory_order_relaxed); }
+        const std::atomic<bool>* get() const { return flag.get(); }
+        
+    private:
+        std::shared_ptr<std::atomic<bool>> flag;
+    };
+    
+    /**
+     * Kết quả của một iteration vừa xong, gửi cho SearchOptions::onProgress
+     */
+    struct SearchProgress {
+        MoveEvaluation bestMove;         // depth = depth của iteration
+        long long nodes;                 // Node tích lũy của worker chính (giống SearchTraceSink)
+        double seconds;                  // Tính từ lúc bắt đầu iterative deepening
+    };
+    
+    using ProgressCallback = std::function<void(const SearchProgress&)>;
+    
+    /**
+     * Tùy chọn cho một lần findBestMove / startSearch; search luôn là iterative deepening từ depth 1
+     * nên dừng ở bất kỳ lúc nào cũng có nước của iteration đã xong gần nhất.
+     * - timeBudget <= 0: không giới hạn thời gian
+     * - depthLimit: 0 = depth của Difficulty; chỉ giảm được, không vượt depth của Difficulty
+     * - stopToken: search đọc cờ mỗi STOP_CHECK_INTERVAL node, threat search mỗi 256 node;
+     *   stopSearch() (và ponderHit trượt) dừng trong cùng giới hạn đó
+     * - onProgress: gọi trên thread search sau mỗi iteration của worker chính; không gọi khi
+     *   nước đến từ book, threat search hay thắng/chặn ngay (không có iteration nào)
+     * - resume: cùng vị trí với lần search trước của AI này thì tiếp tục từ depth sau depth đã
+     *   xong (table vẫn nóng) thay vì bắt đầu lại từ depth 1
+     */
+    struct SearchOptions {
+        std::chrono::milliseconds timeBudget;
+        int depthLimit;
+        StopToken stopToken;
+        ProgressCallback onProgress;
+        bool resume;
         
-        ThinkingStats() : nodesEvaluated(0), pruningCount(0), maxDepthReached(0), timeElapsed(0.0) {}
+        SearchOptions() : timeBudget(0), depthLimit(0), resume(false) {}
     };
 
 private:
@@ -55,67 +136,280 @@ private:
     PlayStyle playStyle;
     int maxDepth;
     int maxCandidates;
+    int threadCount;
+    int vcfDepth;
+    int vctDepth;
+    std::chrono::milliseconds threatTimeLimit;
+    using SearchClock = std::chrono::steady_clock;
+    
+    static const int MAX_PLY = 64;
+    static const int HASH_MOVE_SCORE = 2000000;
+    static const int KILLER_SCORES[2];
+    
+    // Principal variation search
+    static const int SCORE_INFINITY = 1000000000;   // Lớn hơn mọi điểm evaluator, đổi dấu không tràn
+    static const int LMR_MIN_DEPTH = 3;             // Chỉ giảm depth khi node còn >= 3 ply
+    static const int LMR_FULL_DEPTH_MOVES = 3;      // Số nước đầu luôn search đủ depth
+    static const int LMR_DEEP_MOVES = 8;            // Từ nước này trở đi giảm 2 ply thay vì 1
+    static const int MAX_EXTENSIONS = 4;            // Tổng số ply kéo dài cho nước tạo 4 trên một nhánh
+    static constexpr int THREAT_DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    
+    struct SearchWorker {
+        Board board;
+        IncrementalEvaluator evaluator;
+        ThinkingStats stats;
+        int rootDepth;
+        int completedDepth;
+        MoveEvaluation bestMove;
+        int killers[MAX_PLY][2];                 // 2 nước gây cắt gần nhất ở mỗi ply
+        std::vector<int> history;                // Điểm history theo ô (toMoveIndex)
+        
+        // Danh sách nước của mỗi ply, cấp phát một lần cho cả search rồi dùng lại ở mọi node
+        // cùng ply; capacity = số ô nên generateCandidateMoves không bao giờ phải cấp phát lại
+        std::vector<MoveEvaluation> moveBuffers[MAX_PLY];
+        std::vector<MoveEvaluation> criticalScratch;
+        
+        SearchTraceSink* trace;                  // Chỉ worker chính có trace, nullptr nếu tắt
+        const ProgressCallback* progress;        // Chỉ worker chính báo tiến độ, nullptr nếu tắt
+        int pv[MAX_PLY];                         // PV của iteration vừa xong, đọc từ table
+        
+        SearchWorker(const Board& position, int plies, bool trackPatterns)
+            : board(position), history(static_cast<size_t>(Board::MAX_SIZE) * Board::MAX_SIZE, 0) {
+            reset(position, plies, trackPatterns);
+        }
+        
+        /**
+         * Chuẩn bị cho một search mới ở position: xóa killer, history và stats nhưng giữ mọi buffer,
+         * nên worker dùng lại qua nhiều search (vd. mỗi vị trí của BatchAnalyzer) không cấp phát lại
+         */
+        void reset(const Board& position, int plies, bool trackPatterns) {
+            board = position;
+            evaluator.attach(board, trackPatterns);
+            stats = ThinkingStats();
+            rootDepth = 0;
+            completedDepth = 0;
+            bestMove = MoveEvaluation();
+            for (auto& slot : killers) {
+                slot[0] = slot[1] = TranspositionTable::NO_MOVE;
+            }
+            std::fill(history.begin(), history.end(), 0);
+            trace = nullptr;
+            progress = nullptr;
+            
+            size_t cells = static_cast<size_t>(board.getSize()) * board.getSize();
+            for (int ply = 0; ply < std::min(plies, static_cast<int>(MAX_PLY)); ply++) {
+                moveBuffers[ply].reserve(cells);
+            }
+            criticalScratch.reserve(cells);
+        }
+    };
+    
     mutable ThinkingStats lastStats;
+    std::vector<ThinkingStats> lastThreadStats;
     mutable std::mt19937 rng;
+    std::shared_ptr<TranspositionTable> transpositionTable;
+    std::shared_ptr<const OpeningBook> openingBook;
+    std::shared_ptr<SearchTraceSink> traceSink;
+    std::vector<std::unique_ptr<SearchWorker>> workers;   // Giữ qua các search, xem acquireWorkers
+    std::atomic<SearchClock::time_point> searchDeadline;
+    std::atomic<bool> searchAborted;
+    
+    // Tùy chọn của search hiện tại (SearchOptions), đặt trong prepareSearch
+    StopToken stopToken;
+    ProgressCallback progressCallback;
+    int searchDepthLimit;
+    bool resumeRequested;
+    std::uint64_t resumeKey;                     // Vị trí của lần search xong gần nhất
+    MoveEvaluation resumeBest;                   // và nước của iteration cuối cùng đã xong (row = -1: không có)
+    
+    // Search chạy nền (startSearch / startPondering)
+    std::thread searchThread;
+    std::atomic<bool> searchRunning;
+    MoveEvaluation asyncResult;                  // Chỉ đọc sau khi searchRunning == false
+    bool pondering;
+    int ponderRow;                               // Nước dự đoán của đối thủ đang được ponder
+    int ponderCol;
 
 public:
-    AI(int aiPlayerNum = 2, Difficulty diff = Difficulty::MEDIUM, PlayStyle style = PlayStyle::BALANCED) 
+    static const int MAX_THREADS = 256;
+    static const int STOP_CHECK_INTERVAL = 1024;    // Số node giữa hai lần đọc đồng hồ và stop token (lũy thừa 2)
+    
+    /**
+     * @param table Transposition table dùng chung (xem setTranspositionTable); nullptr = tạo table
+     *        mặc định riêng. Truyền table ở đây thay vì setTranspositionTable sau đó để không phải
+     *        cấp phát rồi bỏ table mặc định
+     */
+    AI(int aiPlayerNum = 2, Difficulty diff = Difficulty::MEDIUM, PlayStyle style = PlayStyle::BALANCED,
+       std::shared_ptr<TranspositionTable> table = nullptr)
         : aiPlayer(aiPlayerNum), difficulty(diff), playStyle(style),
-          rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
+          threadCount(1), threatTimeLimit(100), rng(std::chrono::steady_clock::now().time_since_epoch().count()),
+          transpositionTable(table ? std::move(table) : std::make_shared<TranspositionTable>()),
+          searchDeadline(SearchClock::time_point::max()), searchAborted(false),
+          searchDepthLimit(0), resumeRequested(false), resumeKey(0), searchRunning(false),
+          pondering(false), ponderRow(-1), ponderCol(-1) {
         
         humanPlayer = (aiPlayer == 1) ? 2 : 1;
         updateParameters();
     }
     
-    MoveEvaluation findBestMove(const std::vector<std::vector<int>>& board) {
-        lastStats = ThinkingStats();
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        if (isEmpty(board)) {
-            return getOpeningMove(board);
-        }
-        
-        MoveEvaluation specialMove = handleSpecialSituations(board);
-        if (specialMove.row >= 0) {
-            return specialMove;
+    AI(const AI&) = delete;
+    AI& operator=(const AI&) = delete;
+    
+    ~AI() {
+        stopSearch();
+    }
+    
+    MoveEvaluation findBestMove(const BoardView& view) {
+        stopSearch();
+        prepareSearch(SearchClock::time_point::max());
+        return runSearch(Board(view), maxDepth);
+    }
+    
+    MoveEvaluation findBestMove(const BoardView& view, std::chrono::milliseconds timeBudget) {
+        stopSearch();
+        prepareSearch(SearchClock::now() + timeBudget);
+        return runSearch(Board(view), 1);
+    }
+    
+    /**
+     * Search có thể hủy và theo dõi: xem SearchOptions. Bị dừng (token hoặc hết giờ) thì trả về
+     * nước của iteration đã xong gần nhất, depth = depth của iteration đó (0 nếu chưa xong iteration nào)
+     */
+    MoveEvaluation findBestMove(const BoardView& view, const SearchOptions& options) {
+        stopSearch();
+        prepareSearch(options);
+        return runSearch(Board(view), 1);
+    }
+    
+    // ===== Search bất đồng bộ =====
+    // Các setter và findBestMove không được gọi song song với search nền (findBestMove tự dừng nó).
+    // getLastThinkingStats chỉ hợp lệ sau khi search nền kết thúc.
+    
+    /**
+     * Bắt đầu search như findBestMove trên thread nền; view được copy nên có thể đổi ngay sau đó
+     */
+    void startSearch(const BoardView& view) {
+        stopSearch();
+        prepareSearch(SearchClock::time_point::max());
+        launchSearch(Board(view), maxDepth);
+    }
+    
+    void startSearch(const BoardView& view, std::chrono::milliseconds timeBudget) {
+        stopSearch();
+        prepareSearch(SearchClock::now() + timeBudget);
+        launchSearch(Board(view), 1);
+    }
+    
+    /**
+     * onProgress được gọi trên thread nền; stopSearch() và options.stopToken đều dừng được search
+     */
+    void startSearch(const BoardView& view, const SearchOptions& options) {
+        stopSearch();
+        prepareSearch(options);
+        launchSearch(Board(view), 1);
+    }
+    
+    bool isSearching() const {
+        return searchRunning.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * Không chặn: trả về true và ghi kết quả vào move nếu search nền đã xong
+     */
+    bool pollSearch(MoveEvaluation& move) {
+        if (!searchThread.joinable() || isSearching()) {
+            return false;
         }
-        
-        std::vector<MoveEvaluation> candidates = generateCandidateMoves(board);
-        if (candidates.empty()) {
-            return getRandomMove(board);
+        move = waitForSearch();
+        return true;
+    }
+    
+    /**
+     * Chờ search nền xong (row = -1 nếu không có search nào)
+     */
+    MoveEvaluation waitForSearch() {
+        if (!searchThread.joinable()) {
+            return MoveEvaluation();
         }
+        searchThread.join();
+        pondering = false;
+        return asyncResult;
+    }
+    
+    /**
+     * Hủy search nền và trả về nước tốt nhất của lần lặp đã xong gần nhất
+     * (hoặc nước xếp đầu nếu chưa xong lần lặp nào). negamax đọc searchAborted ở mỗi node
+     * và threat search mỗi 256 node, nên chỉ phải chờ vài node chứ không chờ hết threatTimeLimit
+     */
+    MoveEvaluation stopSearch() {
+        searchAborted = true;
+        return waitForSearch();
+    }
+    
+    /**
+     * Ponder trong lúc chờ đối thủ: view là vị trí sau nước của AI, đối thủ sắp đi.
+     * Dự đoán nước trả lời từ best move trong transposition table (PV của lần search trước)
+     * rồi search nền vị trí sau nước đó, không giới hạn thời gian cho tới ponderHit.
+     * @return false nếu không dự đoán được nước đối thủ (không ponder)
+     */
+    bool startPondering(const BoardView& view) {
+        stopSearch();
+        Board board(view);
         
-        sortMoves(candidates, board);
-        
-        MoveEvaluation bestMove;
-        for (auto& candidate : candidates) {
-            std::vector<std::vector<int>> tempBoard = board;
-            tempBoard[candidate.row][candidate.col] = aiPlayer;
-            
-            int score = minimax(tempBoard, maxDepth - 1, false, INT_MIN, INT_MAX,
-                               candidate.row, candidate.col);
-            
-            if (score > bestMove.score) {
-                bestMove = MoveEvaluation(candidate.row, candidate.col, score);
-            }
+        int row, col;
+        if (!predictReply(board, row, col)) {
+            return false;
         }
         
-        auto endTime = std::chrono::high_resolution_clock::now();
-        lastStats.timeElapsed = std::chrono::duration<double>(endTime - startTime).count();
-        
-        return bestMove;
+        board.makeMove(row, col, humanPlayer);
+        prepareSearch(SearchClock::time_point::max());
+        launchSearch(std::move(board), 1);
+        pondering = true;
+        ponderRow = row;
+        ponderCol = col;
+        return true;
+    }
+    
+    bool isPondering() const { return pondering; }
+    
+    MoveEvaluation getPonderMove() const {
+        return pondering ? MoveEvaluation(ponderRow, ponderCol) : MoveEvaluation();
+    }
+    
+    /**
+     * Báo nước đối thủ vừa đi khi đang ponder.
+     * Đoán trúng: search nền tiếp tục như một startSearch bình thường (giữ nguyên các lần
+     * lặp đã xong và table đang nóng), lấy kết quả bằng waitForSearch/pollSearch.
+     * Đoán trượt: hủy ngay ponder search và trả về false; gọi findBestMove/startSearch như thường.
+     */
+    bool ponderHit(int row, int col) {
+        return ponderHit(row, col, SearchClock::time_point::max());
     }
     
-    std::vector<MoveEvaluation> getTopMoves(const std::vector<std::vector<int>>& board, int count = 5) {
+    bool ponderHit(int row, int col, std::chrono::milliseconds timeBudget) {
+        return ponderHit(row, col, SearchClock::now() + timeBudget);
+    }
+    
+    std::vector<MoveEvaluation> getTopMoves(const BoardView& view, int count = 5) {
+        stopSearch();
+        Board board(view);
         std::vector<MoveEvaluation> candidates = generateCandidateMoves(board);
+        SearchWorker& worker = *acquireWorkers(board, 1, std::min(maxDepth, 4) + MAX_EXTENSIONS + 2)[0];
+        transpositionTable->newSearch();
+        prepareSearch(SearchClock::time_point::max());
+        worker.rootDepth = std::min(maxDepth, 4) + 1;
         
         for (auto& candidate : candidates) {
-            std::vector<std::vector<int>> tempBoard = board;
-            tempBoard[candidate.row][candidate.col] = aiPlayer;
+            makeSearchMove(worker, candidate.row, candidate.col, aiPlayer);
+            
+            // Cửa sổ đầy đủ cho từng nước để điểm trả về là chính xác, không chỉ là cận
+            candidate.score = -negamax(worker, std::min(maxDepth, 4), 1, 0, false,
+                                       -SCORE_INFINITY, SCORE_INFINITY, candidate.row, candidate.col);
             
-            candidate.score = minimax(tempBoard, std::min(maxDepth, 4), false, 
-                                     INT_MIN, INT_MAX, candidate.row, candidate.col);
+            undoSearchMove(worker);
         }
+        lastStats = worker.stats;
+        finishStats(lastStats);
         
         std::sort(candidates.begin(), candidates.end(),
                   [](const MoveEvaluation& a, const MoveEvaluation& b) {
@@ -129,15 +423,87 @@ public:
     void setDifficulty(Difficulty diff) {
         difficulty = diff;
         updateParameters();
+        resumeBest = MoveEvaluation();
     }
     
     void setPlayStyle(PlayStyle style) {
         playStyle = style;
+        transpositionTable->clear();
+        resumeBest = MoveEvaluation();
+    }
+    
+    /**
+     * Số nước ứng viên tối đa mỗi node; setDifficulty đặt lại về mặc định của difficulty
+     */
+    void setMaxCandidates(int count) {
+        maxCandidates = std::max(1, count);
+        resumeBest = MoveEvaluation();
+    }
+    
+    /**
+     * Seed cho nước ngẫu nhiên (BEGINNER); mặc định lấy từ đồng hồ. Cùng seed, cùng vị trí
+     * và search theo depth (không time budget) cho cùng nước đi
+     */
+    void setSeed(std::uint32_t seed) {
+        rng.seed(seed);
+    }
+    
+    void setHashSize(size_t megabytes) {
+        transpositionTable->resize(megabytes);
+    }
+    
+    void clearHash() {
+        transpositionTable->clear();
+    }
+    
+    /**
+     * Dùng chung table với AI khác (vd. mọi worker của GameServer); nullptr = giữ table hiện tại.
+     * Key đã gồm bên sắp đi so với aiPlayer nên AI cầm quân khác nhau dùng chung vẫn đúng,
+     * nhưng các AI chung table phải cùng PlayStyle (điểm lưu trong table phụ thuộc style)
+     */
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> table) {
+        stopSearch();
+        if (table) {
+            transpositionTable = std::move(table);
+        }
+    }
+    
+    /**
+     * Lazy SMP: threadCount - 1 helper thread cùng search vị trí gốc, chia sẻ transposition table
+     */
+    void setThreadCount(int count) {
+        threadCount = std::max(1, std::min(count, static_cast<int>(MAX_THREADS)));
+    }
+    
+    /**
+     * Giới hạn threat-space search chạy trước negamax; depth = số nước tấn công, 0 = tắt
+     */
+    void setThreatSearchLimits(int vcf, int vct, std::chrono::milliseconds timeLimit) {
+        vcfDepth = std::max(0, vcf);
+        vctDepth = std::max(0, vct);
+        threatTimeLimit = timeLimit;
+    }
+    
+    /**
+     * Sách khai cuộc (có thể dùng chung giữa nhiều AI); nullptr = tắt. Nước sách bỏ qua search
+     */
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+        openingBook = std::move(book);
+    }
+    
+    /**
+     * Nhận PV sau mỗi iteration (và từng cạnh của cây nếu build với CARO_SEARCH_PROFILE); nullptr = tắt
+     */
+    void setTraceSink(std::shared_ptr<SearchTraceSink> sink) {
+        traceSink = std::move(sink);
     }
     
     Difficulty getDifficulty() const { return difficulty; }
     PlayStyle getPlayStyle() const { return playStyle; }
+    int getMaxCandidates() const { return maxCandidates; }
     const ThinkingStats& getLastThinkingStats() const { return lastStats; }
+    const std::vector<ThinkingStats>& getThreadStats() const { return lastThreadStats; }
+    int getThreadCount() const { return threadCount; }
     int getAIPlayer() const { return aiPlayer; }
     int getHumanPlayer() const { return humanPlayer; }
 
@@ -148,404 +514,824 @@ private:
         switch (difficulty) {
             case Difficulty::BEGINNER:
                 maxCandidates = 8;
+                vcfDepth = 0;
+                vctDepth = 0;
                 break;
             case Difficulty::EASY:
                 maxCandidates = 12;
+                vcfDepth = 0;
+                vctDepth = 0;
                 break;
             case Difficulty::MEDIUM:
                 maxCandidates = 16;
+                vcfDepth = 6;
+                vctDepth = 0;
                 break;
             case Difficulty::HARD:
                 maxCandidates = 20;
+                vcfDepth = 10;
+                vctDepth = 2;
                 break;
             case Difficulty::EXPERT:
                 maxCandidates = 25;
+                vcfDepth = 12;
+                vctDepth = 3;
                 break;
         }
     }
     
-    bool isEmpty(const std::vector<std::vector<int>>& board) {
-        for (const auto& row : board) {
-            for (int cell : row) {
-                if (cell != 0) return false;
-            }
+    bool ponderHit(int row, int col, SearchClock::time_point deadline) {
+        if (!pondering) {
+            return false;
+        }
+        if (row != ponderRow || col != ponderCol) {
+            stopSearch();
+            return false;
         }
+        
+        searchDeadline = deadline;
+        pondering = false;
         return true;
     }
     
-    MoveEvaluation getOpeningMove(const std::vector<std::vector<int>>& board) {
-        int size = board.size();
-        return MoveEvaluation(size / 2, size / 2, 1000);
+    /**
+     * Đặt lại cờ dừng, deadline và tùy chọn trước khi search; không làm trong runSearch để một
+     * stopSearch/ponderHit gọi ngay sau launchSearch không bị thread nền ghi đè
+     */
+    void prepareSearch(SearchClock::time_point deadline) {
+        prepareSearch(deadline, SearchOptions());
     }
     
-    MoveEvaluation handleSpecialSituations(const std::vector<std::vector<int>>& board) {
-        int size = board.size();
-        
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] == 0) {
-                    if (isWinningThreat(board, i, j, aiPlayer)) {
-                        return MoveEvaluation(i, j, 1000000);
-                    }
-                    
-                    if (isWinningThreat(board, i, j, humanPlayer)) {
-                        return MoveEvaluation(i, j, 999999);
-                    }
-                }
-            }
+    void prepareSearch(const SearchOptions& options) {
+        prepareSearch(options.timeBudget.count() > 0 ? SearchClock::now() + options.timeBudget
+                                                     : SearchClock::time_point::max(), options);
+    }
+    
+    void prepareSearch(SearchClock::time_point deadline, const SearchOptions& options) {
+        searchDeadline = deadline;
+        searchAborted = false;
+        stopToken = options.stopToken;
+        progressCallback = options.onProgress;
+        searchDepthLimit = options.depthLimit > 0 ? std::min(options.depthLimit, maxDepth) : maxDepth;
+        resumeRequested = options.resume;
+    }
+    
+    /**
+     * Deadline hoặc stop token; chỉ gọi mỗi STOP_CHECK_INTERVAL node vì phải đọc đồng hồ
+     */
+    bool shouldStop() const {
+        return stopToken.stopRequested() || SearchClock::now() >= searchDeadline.load(std::memory_order_relaxed);
+    }
+    
+    void launchSearch(Board board, int firstDepth) {
+        searchRunning = true;
+        searchThread = std::thread([this, firstDepth](Board position) {
+            asyncResult = runSearch(std::move(position), firstDepth);
+            searchRunning.store(false, std::memory_order_release);
+        }, std::move(board));
+    }
+    
+    /**
+     * Nước trả lời đối thủ theo PV: best move lưu trong table ở vị trí đối thủ sắp đi
+     */
+    bool predictReply(const Board& board, int& row, int& col) const {
+        TranspositionTable::Entry entry;
+        if (!transpositionTable->probe(board.getHashKey() ^ Zobrist::sideKey(), entry) ||
+            entry.move == TranspositionTable::NO_MOVE) {
+            return false;
         }
         
-        return MoveEvaluation();
+        row = entry.move / Board::MAX_SIZE;
+        col = entry.move % Board::MAX_SIZE;
+        if (board.getCell(row, col) != Board::EMPTY) {
+            return false;
+        }
+        // Đối thủ thắng ngay bằng nước đó thì không có gì để ponder
+        return !board.makesFive(row, col, humanPlayer);
     }
     
-    std::vector<MoveEvaluation> generateCandidateMoves(const std::vector<std::vector<int>>& board) {
-        std::vector<MoveEvaluation> candidates;
-        std::vector<MoveEvaluation> criticalMoves = getCriticalMoves(board);
-        std::vector<MoveEvaluation> neighborMoves = getNeighborMoves(board);
+    MoveEvaluation runSearch(Board board, int firstDepth) {
+        lastStats = ThinkingStats();
+        auto startTime = std::chrono::high_resolution_clock::now();
         
-        candidates.insert(candidates.end(), criticalMoves.begin(), criticalMoves.end());
+        MoveEvaluation specialMove = handleSpecialSituations(board);
+        if (specialMove.row >= 0) {
+            return specialMove;
+        }
         
-        for (const auto& move : neighborMoves) {
-            bool isDuplicate = false;
-            for (const auto& existing : candidates) {
-                if (existing.row == move.row && existing.col == move.col) {
-                    isDuplicate = true;
-                    break;
-                }
+        OpeningBook::Entry bookEntry;
+        if (openingBook && openingBook->probe(board, aiPlayer, bookEntry)) {
+            lastStats.bookHits++;
+            lastStats.timeElapsed = std::chrono::duration<double>(
+                std::chrono::high_resolution_clock::now() - startTime).count();
+            return MoveEvaluation(bookEntry.row, bookEntry.col, bookEntry.weight);
+        }
+        
+        if (isEmpty(board)) {
+            return getOpeningMove(board);
+        }
+        
+        MoveEvaluation threatMove = solveThreats(board, searchDeadline.load());
+        if (threatMove.row >= 0) {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            lastStats.timeElapsed = std::chrono::duration<double>(endTime - startTime).count();
+            return threatMove;
+        }
+        
+        std::vector<MoveEvaluation> candidates = generateCandidateMoves(board);
+        if (candidates.empty()) {
+            return getRandomMove(board);
+        }
+        
+        sortMoves(candidates);
+        transpositionTable->newSearch();
+        
+        // SearchOptions::resume: bắt đầu sau depth đã xong, nước của lần trước được search đầu tiên
+        MoveEvaluation resumed;
+        if (resumeRequested && resumeBest.row >= 0 && resumeKey == board.getHashKey()) {
+            resumed = resumeBest;
+            if (resumed.depth >= searchDepthLimit) {
+                lastStats.maxDepthReached = resumed.depth;
+                return resumed;
             }
-            if (!isDuplicate) {
-                candidates.push_back(move);
+            firstDepth = std::max(firstDepth, resumed.depth + 1);
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](const MoveEvaluation& move) {
+                return move.row == resumed.row && move.col == resumed.col;
+            });
+            if (it != candidates.end()) {
+                std::rotate(candidates.begin(), it, it + 1);
             }
         }
+        if (stopToken.stopRequested()) {
+            searchAborted = true;
+        }
+        
+        acquireWorkers(board, threadCount, maxDepth + MAX_EXTENSIONS + 1);
+        
+        // Helper bắt đầu lệch depth và thứ tự gốc để không search trùng hệt main thread
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < threadCount; i++) {
+            helpers.emplace_back([this, candidates, firstDepth, i]() mutable {
+                std::rotate(candidates.begin(), candidates.begin() + (i % candidates.size()), candidates.end());
+                iterativeDeepening(*workers[i], candidates, std::min(firstDepth + (i & 1), searchDepthLimit));
+            });
+        }
         
-        if (candidates.size() > maxCandidates) {
-            candidates.resize(maxCandidates);
+        SearchWorker& mainWorker = *workers[0];
+        mainWorker.trace = traceSink.get();
+        mainWorker.progress = progressCallback ? &progressCallback : nullptr;
+        if (resumed.row >= 0) {
+            mainWorker.bestMove = resumed;
+            mainWorker.completedDepth = resumed.depth;
         }
+        iterativeDeepening(mainWorker, candidates, firstDepth);
         
-        return candidates;
+        searchAborted = true;
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        
+        MoveEvaluation bestMove = mainWorker.bestMove;
+        if (bestMove.row < 0) {
+            bestMove = candidates.front();
+        } else {
+            resumeKey = board.getHashKey();
+            resumeBest = bestMove;
+        }
+        
+        lastThreadStats.clear();
+        lastStats.profile = mainWorker.stats.profile;
+        for (int i = 0; i < threadCount; i++) {
+            const auto& worker = workers[i];
+            lastThreadStats.push_back(worker->stats);
+            lastStats.nodesEvaluated += worker->stats.nodesEvaluated;
+            lastStats.pruningCount += worker->stats.pruningCount;
+            lastStats.reducedMoves += worker->stats.reducedMoves;
+            lastStats.researches += worker->stats.researches;
+            lastStats.ttHits += worker->stats.ttHits;
+            lastStats.ttMisses += worker->stats.ttMisses;
+            lastStats.searchAllocations += worker->stats.searchAllocations;
+            if (worker.get() != &mainWorker) {
+                lastStats.profile.merge(worker->stats.profile);
+            }
+        }
+        lastStats.maxDepthReached = mainWorker.completedDepth;
+        
+        auto endTime = std::chrono::high_resolution_clock::now();
+        lastStats.timeElapsed = std::chrono::duration<double>(endTime - startTime).count();
+        finishStats(lastStats);
+        
+        return bestMove;
     }
     
-    std::vector<MoveEvaluation> getCriticalMoves(const std::vector<std::vector<int>>& board) {
-        std::vector<MoveEvaluation> criticalMoves;
-        int size = board.size();
+    /**
+     * Worker cho count thread, đã reset về board; chỉ tạo worker mới khi threadCount tăng,
+     * buffer của worker cũ (move list, history, evaluator) được dùng lại
+     */
+    const std::vector<std::unique_ptr<SearchWorker>>& acquireWorkers(const Board& board, int count, int plies) {
+        for (int i = 0; i < count; i++) {
+            if (i < static_cast<int>(workers.size())) {
+                workers[i]->reset(board, plies, usesPatternScore());
+            } else {
+                workers.push_back(std::make_unique<SearchWorker>(board, plies, usesPatternScore()));
+            }
+        }
+        return workers;
+    }
+    
+    void iterativeDeepening(SearchWorker& worker, std::vector<MoveEvaluation> candidates, int firstDepth) {
+        const long long allocationsBefore = AllocationCounter::count();
+        const auto startTime = SearchClock::now();
         
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] == 0) {
-                    MoveEvaluation move(i, j, 0);
-                    
-                    if (isWinningThreat(board, i, j, aiPlayer)) {
-                        move.score = 1000000;
-                        move.isWinning = true;
-                        criticalMoves.push_back(move);
-                    }
-                    else if (isWinningThreat(board, i, j, humanPlayer)) {
-                        move.score = 999999;
-                        move.isBlocking = true;
-                        criticalMoves.push_back(move);
-                    }
-                }
+        for (int depth = firstDepth; depth <= searchDepthLimit; depth++) {
+            // Token bật giữa hai iteration (vd. trong onProgress) thì không bắt đầu depth mới
+            if (stopToken.stopRequested()) {
+                searchAborted = true;
+                break;
+            }
+            const long long nodesBefore = worker.stats.nodesEvaluated;
+            MoveEvaluation iterationBest = searchRoot(worker, candidates, depth);
+            if (searchAborted.load(std::memory_order_relaxed)) {
+                break;
+            }
+            
+            worker.bestMove = iterationBest;
+            worker.bestMove.depth = depth;
+            worker.completedDepth = depth;
+            worker.stats.profile.recordIteration(depth, worker.stats.nodesEvaluated - nodesBefore);
+            if (worker.trace) {
+                traceIteration(worker, iterationBest, depth, startTime);
             }
+            if (worker.progress) {
+                SearchProgress progress;
+                progress.bestMove = worker.bestMove;
+                progress.nodes = worker.stats.nodesEvaluated;
+                progress.seconds = std::chrono::duration<double>(SearchClock::now() - startTime).count();
+                (*worker.progress)(progress);
+            }
+            
+            // Nước tốt nhất của lần lặp trước được search đầu tiên ở lần sau
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](const MoveEvaluation& move) {
+                return move.row == iterationBest.row && move.col == iterationBest.col;
+            });
+            std::rotate(candidates.begin(), it, it + 1);
         }
         
-        return criticalMoves;
+        worker.stats.maxDepthReached = worker.completedDepth;
+        worker.stats.searchAllocations = AllocationCounter::count() - allocationsBefore;
     }
     
-    std::vector<MoveEvaluation> getNeighborMoves(const std::vector<std::vector<int>>& board) {
-        std::vector<MoveEvaluation> neighborMoves;
-        int size = board.size();
-        std::vector<std::vector<bool>> visited(size, std::vector<bool>(size, false));
+    /**
+     * Gốc cũng là PVS: nước đầu (nước tốt nhất của iteration trước) search cửa sổ đầy đủ,
+     * các nước sau chỉ cần chứng minh không tốt hơn alpha; gốc không giảm depth
+     */
+    MoveEvaluation searchRoot(SearchWorker& worker, const std::vector<MoveEvaluation>& candidates, int depth) {
+        worker.rootDepth = depth;
+        MoveEvaluation bestMove;
+        int alpha = -SCORE_INFINITY;
+        size_t searched = 0;
         
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] != 0) {
-                    for (int di = -2; di <= 2; di++) {
-                        for (int dj = -2; dj <= 2; dj++) {
-                            int ni = i + di;
-                            int nj = j + dj;
-                            
-                            if (ni >= 0 && ni < size && nj >= 0 && nj < size &&
-                                board[ni][nj] == 0 && !visited[ni][nj]) {
-                                neighborMoves.emplace_back(ni, nj);
-                                visited[ni][nj] = true;
-                            }
-                        }
-                    }
+        for (const auto& candidate : candidates) {
+            const int extension = threatExtension(worker.board, candidate.row, candidate.col, aiPlayer, 0);
+            makeSearchMove(worker, candidate.row, candidate.col, aiPlayer);
+            
+            int score;
+            if (searched == 0) {
+                score = -negamax(worker, depth - 1 + extension, 1, extension, false,
+                                 -SCORE_INFINITY, -alpha, candidate.row, candidate.col);
+            } else {
+                score = -negamax(worker, depth - 1 + extension, 1, extension, false,
+                                 -alpha - 1, -alpha, candidate.row, candidate.col);
+                if (score > alpha && !searchAborted.load(std::memory_order_relaxed)) {
+                    worker.stats.researches++;
+                    score = -negamax(worker, depth - 1 + extension, 1, extension, false,
+                                     -SCORE_INFINITY, -alpha, candidate.row, candidate.col);
                 }
             }
+            
+            undoSearchMove(worker);
+            
+            if (searchAborted.load(std::memory_order_relaxed)) {
+                break;
+            }
+            searched++;
+            traceNode(worker, 0, candidate, aiPlayer, alpha, SCORE_INFINITY, score, false);
+            
+            if (score > bestMove.score) {
+                bestMove = MoveEvaluation(candidate.row, candidate.col, score);
+                alpha = std::max(alpha, score);
+            }
         }
+        worker.stats.profile.recordExpansion(0, static_cast<long long>(searched));
         
-        return neighborMoves;
+        return bestMove;
     }
     
-    void sortMoves(std::vector<MoveEvaluation>& moves, const std::vector<std::vector<int>>& board) {
-        for (auto& move : moves) {
-            move.score = quickEvaluateMove(board, move.row, move.col, aiPlayer);
-        }
-        
-        std::sort(moves.begin(), moves.end(),
-                  [](const MoveEvaluation& a, const MoveEvaluation& b) {
-                      return a.score > b.score;
-                  });
+    bool isEmpty(const Board& board) {
+        return board.isEmpty();
     }
     
-    int quickEvaluateMove(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        return evaluatePosition(board, row, col, player);
+    MoveEvaluation getOpeningMove(const Board& board) {
+        int size = board.getSize();
+        return MoveEvaluation(size / 2, size / 2, 1000);
     }
     
-    int minimax(std::vector<std::vector<int>>& board, int depth, bool isMaximizing,
-                int alpha, int beta, int lastRow = -1, int lastCol = -1) {
-        
-        lastStats.nodesEvaluated++;
-        lastStats.maxDepthReached = std::max(lastStats.maxDepthReached, maxDepth - depth);
-        
-        if (isTerminalState(board, lastRow, lastCol) || depth <= 0) {
-            return evaluateBoard(board);
+    MoveEvaluation handleSpecialSituations(const Board& board) {
+        // Ô tạo 5 luôn kề một quân nên chỉ cần xét tập ứng viên.
+        // Thắng ngay luôn ưu tiên hơn chặn, nên quét 2 lượt
+        for (const auto& [i, j] : board.getCandidateCells()) {
+            if (GameLogic::isWinningThreat(board, i, j, aiPlayer)) {
+                return MoveEvaluation(i, j, 1000000);
+            }
         }
         
-        std::vector<MoveEvaluation> moves = generateCandidateMoves(board);
-        if (moves.empty()) {
-            return evaluateBoard(board);
+        for (const auto& [i, j] : board.getCandidateCells()) {
+            if (GameLogic::isWinningThreat(board, i, j, humanPlayer)) {
+                return MoveEvaluation(i, j, 999999);
+            }
         }
         
-        sortMoves(moves, board);
+        return MoveEvaluation();
+    }
+    
+    /**
+     * Thử VCF rồi VCT cho AI; chỉ trả về nước khi chứng minh được thắng cưỡng bức
+     */
+    MoveEvaluation solveThreats(Board& board, SearchClock::time_point deadline) {
+        ThreatSearch solver;
+        const ThreatSearch::Limits stages[2] = {
+            ThreatSearch::Limits(vcfDepth, false, threatTimeLimit),
+            ThreatSearch::Limits(vctDepth, true, threatTimeLimit)
+        };
         
-        if (isMaximizing) {
-            int maxEval = INT_MIN;
+        for (const auto& limits : stages) {
+            if (limits.maxDepth <= 0) continue;
             
-            for (const auto& move : moves) {
-                board[move.row][move.col] = aiPlayer;
-                
-                int eval = minimax(board, depth - 1, false, alpha, beta, 
-                                  move.row, move.col);
-                
-                board[move.row][move.col] = 0;
-                
-                maxEval = std::max(maxEval, eval);
-                alpha = std::max(alpha, eval);
-                
-                if (beta <= alpha) {
-                    lastStats.pruningCount++;
-                    break;
-                }
-            }
-            return maxEval;
+            // searchAborted để stopSearch()/ponderHit trượt dừng được cả threat search, không chỉ token
+            ThreatSearch::Result result = solver.solve(board, aiPlayer, limits, deadline, stopToken.get(),
+                                                       &searchAborted);
+            lastStats.threatNodes += solver.getStats().nodesSearched;
+            lastStats.threatPositionsSolved += solver.getStats().positionsSolved;
             
-        } else {
-            int minEval = INT_MAX;
-            
-            for (const auto& move : moves) {
-                board[move.row][move.col] = humanPlayer;
-                
-                int eval = minimax(board, depth - 1, true, alpha, beta,
-                                  move.row, move.col);
-                
-                board[move.row][move.col] = 0;
-                
-                minEval = std::min(minEval, eval);
-                beta = std::min(beta, eval);
-                
-                if (beta <= alpha) {
-                    lastStats.pruningCount++;
-                    break;
-                }
+            if (result.found) {
+                MoveEvaluation move(result.row, result.col, 1000000);
+                move.depth = result.depth;
+                move.isWinning = true;
+                return move;
+            }
+            if (solver.getStats().timedOut && searchAborted.load(std::memory_order_relaxed)) {
+                break;
             }
-            return minEval;
         }
+        
+        return MoveEvaluation();
     }
     
-    bool isTerminalState(const std::vector<std::vector<int>>& board, int lastRow, int lastCol) {
-        if (lastRow >= 0 && lastCol >= 0) {
-            return checkWin(board, lastRow, lastCol, board[lastRow][lastCol]);
-        }
-        return false;
+    std::vector<MoveEvaluation> generateCandidateMoves(const Board& board) {
+        std::vector<MoveEvaluation> candidates;
+        std::vector<MoveEvaluation> criticalMoves;
+        generateCandidateMoves(board, candidates, criticalMoves);
+        return candidates;
     }
     
-    bool checkWin(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        if (row < 0 || col < 0 || board[row][col] != player) return false;
-        
-        int size = board.size();
-        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    /**
+     * Một lượt qua tập ứng viên: nước thắng/chặn (đã sort) đứng đầu, sau đó là các nước
+     * còn lại với điểm nhanh. Ghi vào buffer của caller, không cấp phát khi đủ capacity
+     */
+    void generateCandidateMoves(const Board& board, std::vector<MoveEvaluation>& candidates,
+                                std::vector<MoveEvaluation>& criticalMoves) {
+        candidates.clear();
+        criticalMoves.clear();
         
-        for (int dir = 0; dir < 4; dir++) {
-            int dx = directions[dir][0];
-            int dy = directions[dir][1];
-            int count = 1;
+        for (const auto& [i, j] : board.getCandidateCells()) {
+            MoveEvaluation move(i, j, 0);
             
-            int x = row + dx, y = col + dy;
-            while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-                count++;
-                x += dx;
-                y += dy;
+            if (GameLogic::isWinningThreat(board, i, j, aiPlayer)) {
+                move.score = 1000000;
+                move.isWinning = true;
+                criticalMoves.push_back(move);
             }
-            
-            x = row - dx, y = col - dy;
-            while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-                count++;
-                x -= dx;
-                y -= dy;
+            else if (GameLogic::isWinningThreat(board, i, j, humanPlayer)) {
+                move.score = 999999;
+                move.isBlocking = true;
+                criticalMoves.push_back(move);
+            }
+            else {
+                move.score = quickEvaluateMove(board, i, j, aiPlayer);
+                candidates.push_back(move);
             }
-            
-            if (count >= 5) return true;
         }
         
-        return false;
+        std::sort(criticalMoves.begin(), criticalMoves.end(), isBetterMove);
+        candidates.insert(candidates.begin(), criticalMoves.begin(), criticalMoves.end());
+        
+        // Thứ tự tập ứng viên phụ thuộc lịch sử make/unmake, nên giữ lại các nước có điểm
+        // nhanh cao nhất (hòa thì theo chỉ số ô) để cùng vị trí luôn cho cùng tập nước
+        size_t limit = static_cast<size_t>(maxCandidates);
+        if (candidates.size() > limit) {
+            auto rest = candidates.begin() + std::min(criticalMoves.size(), limit);
+            std::nth_element(rest, candidates.begin() + limit, candidates.end(), isBetterMove);
+            candidates.resize(limit);
+        }
     }
     
-    bool isWinningThreat(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        if (row < 0 || col < 0 || row >= board.size() || col >= board[0].size() || board[row][col] != 0) {
-            return false;
-        }
-        
-        std::vector<std::vector<int>> tempBoard = board;
-        tempBoard[row][col] = player;
-        
-        return checkWin(tempBoard, row, col, player);
+    /**
+     * Sắp xếp đầy đủ theo điểm của generateCandidateMoves; chỉ dùng ở gốc
+     */
+    void sortMoves(std::vector<MoveEvaluation>& moves) {
+        std::sort(moves.begin(), moves.end(), isBetterMove);
     }
     
-    int evaluateBoard(const std::vector<std::vector<int>>& board) {
-        int aiScore = evaluatePlayerPosition(board, aiPlayer);
-        int humanScore = evaluatePlayerPosition(board, humanPlayer);
-        
-        int baseScore = aiScore - humanScore;
-        return evaluateWithStyle(board, baseScore);
+    /**
+     * Thứ tự toàn phần: điểm cao trước, hòa điểm thì ô có chỉ số nhỏ trước
+     */
+    static bool isBetterMove(const MoveEvaluation& a, const MoveEvaluation& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return toMoveIndex(a.row, a.col) < toMoveIndex(b.row, b.col);
     }
     
-    int evaluatePlayerPosition(const std::vector<std::vector<int>>& board, int player) {
-        int totalScore = 0;
-        int size = board.size();
+    /**
+     * Điểm thứ tự trong cây: hash move > thắng/chặn > killer > điểm nhanh + history.
+     * Điểm nhanh + history bị chặn dưới KILLER_SCORES[1] để history tích lũy trong search dài
+     * không đẩy nước yên tĩnh lên trên killer hay nước thắng/chặn
+     */
+    void scoreMoves(const SearchWorker& worker, std::vector<MoveEvaluation>& moves, int ply, int hashMove) {
+        const int* killers = worker.killers[std::min(ply, MAX_PLY - 1)];
         
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] == 0 && hasAdjacentPieces(board, i, j, 2)) {
-                    totalScore += evaluatePosition(board, i, j, player);
-                }
+        for (auto& move : moves) {
+            int index = toMoveIndex(move.row, move.col);
+            if (index == hashMove) {
+                move.score = HASH_MOVE_SCORE;
+            } else if (move.isWinning || move.isBlocking) {
+                continue;
+            } else if (index == killers[0]) {
+                move.score = KILLER_SCORES[0];
+            } else if (index == killers[1]) {
+                move.score = KILLER_SCORES[1];
+            } else {
+                move.score = std::min(move.score + worker.history[index], KILLER_SCORES[1] - 1);
             }
         }
-        
-        return totalScore;
     }
     
-    int evaluateWithStyle(const std::vector<std::vector<int>>& board, int baseScore) {
-        switch (playStyle) {
-            case PlayStyle::AGGRESSIVE:
-                return baseScore + evaluatePatterns(board, aiPlayer) / 2;
-            case PlayStyle::DEFENSIVE:
-                return baseScore - evaluatePatterns(board, humanPlayer) / 2;
-            case PlayStyle::POSITIONAL:
-                return baseScore + evaluateCenterControl(board, aiPlayer);
-            case PlayStyle::BALANCED:
-            default:
-                return baseScore;
+    /**
+     * Chọn dần: đưa nước điểm cao nhất còn lại về vị trí next, tránh sort cả danh sách
+     * khi node bị cắt sau vài nước đầu
+     */
+    static void pickNextMove(std::vector<MoveEvaluation>& moves, size_t next) {
+        size_t best = next;
+        for (size_t i = next + 1; i < moves.size(); i++) {
+            if (isBetterMove(moves[i], moves[best])) {
+                best = i;
+            }
         }
+        std::swap(moves[next], moves[best]);
     }
     
-    int evaluatePosition(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        int score = 0;
-        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    void recordCutoff(SearchWorker& worker, int ply, const MoveEvaluation& move, int depth) {
+        int index = toMoveIndex(move.row, move.col);
+        worker.history[index] = std::min(worker.history[index] + depth * depth, KILLER_SCORES[1]);
         
-        for (int dir = 0; dir < 4; dir++) {
-            int dx = directions[dir][0];
-            int dy = directions[dir][1];
-            
-            int count = countInLine(board, row, col, dx, dy, player);
-            if (count >= 5) score += 100000;
-            else if (count == 4) score += 10000;
-            else if (count == 3) score += 1000;
-            else if (count == 2) score += 100;
-            else if (count == 1) score += 10;
+        if (move.isWinning || move.isBlocking) {
+            return;
         }
         
-        return score;
+        int* killers = worker.killers[std::min(ply, MAX_PLY - 1)];
+        if (killers[0] != index) {
+            killers[1] = killers[0];
+            killers[0] = index;
+        }
     }
     
-    int evaluatePatterns(const std::vector<std::vector<int>>& board, int player) {
-        int score = 0;
-        int size = board.size();
-        
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] == player) {
-                    score += evaluatePosition(board, i, j, player);
-                }
+    int quickEvaluateMove(const Board& board, int row, int col, int player) {
+        return IncrementalEvaluator::pointScore(board, row, col, player);
+    }
+    
+    /**
+     * Nước của player tại ô trống (row, col) tạo 4 (đối thủ buộc phải chặn) -> kéo dài 1 ply,
+     * trong giới hạn MAX_EXTENSIONS của cả nhánh
+     */
+    int threatExtension(const Board& board, int row, int col, int player, int extensions) const {
+        if (extensions >= MAX_EXTENSIONS) {
+            return 0;
+        }
+        for (const auto& direction : THREAT_DIRECTIONS) {
+            GameLogic::PatternType pattern = GameLogic::getPattern(board, row, col, direction[0], direction[1], player);
+            if (pattern == GameLogic::PatternType::FOUR_OPEN || pattern == GameLogic::PatternType::FOUR_SEMI) {
+                return 1;
             }
         }
-        
-        return score;
+        return 0;
+    }
+    
+    /**
+     * Nước yên tĩnh được phép giảm depth: không thắng/chặn, không phải hash/killer move
+     * và không tạo 3 mở hay 4 cho player
+     */
+    bool isQuietMove(const SearchWorker& worker, const MoveEvaluation& move, int ply, int hashMove, int player) const {
+        if (move.isWinning || move.isBlocking) {
+            return false;
+        }
+        int index = toMoveIndex(move.row, move.col);
+        const int* killers = worker.killers[std::min(ply, MAX_PLY - 1)];
+        if (index == hashMove || index == killers[0] || index == killers[1]) {
+            return false;
+        }
+        for (const auto& direction : THREAT_DIRECTIONS) {
+            GameLogic::PatternType pattern = GameLogic::getPattern(worker.board, move.row, move.col,
+                                                                   direction[0], direction[1], player);
+            if (pattern == GameLogic::PatternType::THREE_OPEN || pattern == GameLogic::PatternType::FOUR_OPEN ||
+                pattern == GameLogic::PatternType::FOUR_SEMI) {
+                return false;
+            }
+        }
+        return true;
     }
     
-    int evaluateCenterControl(const std::vector<std::vector<int>>& board, int player) {
-        int score = 0;
-        int size = board.size();
-        int centerRow = size / 2;
-        int centerCol = size / 2;
+    /**
+     * Negamax PVS; điểm luôn theo góc nhìn bên đi (AI đi: +evaluateBoard, đối thủ đi: -evaluateBoard),
+     * table cũng lưu theo góc nhìn đó (key đã phân biệt bên đi bằng Zobrist::sideKey).
+     * - Nước đầu search cửa sổ (alpha, beta); các nước sau null window (alpha, alpha + 1),
+     *   vượt alpha mà còn dưới beta thì search lại cửa sổ đầy đủ
+     * - LMR: nước yên tĩnh từ nước thứ LMR_FULL_DEPTH_MOVES ở node depth >= LMR_MIN_DEPTH giảm
+     *   1 ply (2 ply từ LMR_DEEP_MOVES); vượt alpha thì search lại đủ depth
+     * - Nước tạo 4 được kéo dài 1 ply vì nước đáp của đối thủ gần như bị ép
+     * ply = khoảng cách từ gốc; depth không còn suy ra được ply vì có giảm và kéo dài.
+     */
+    int negamax(SearchWorker& worker, int depth, int ply, int extensions, bool aiToMove,
+                int alpha, int beta, int lastRow = -1, int lastCol = -1) {
+        
+        if (searchAborted.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        
+        ThinkingStats& stats = worker.stats;
+        const Board& board = worker.board;
+        stats.nodesEvaluated++;
+        stats.maxDepthReached = std::max(stats.maxDepthReached, ply);
+        
+        if ((stats.nodesEvaluated & (STOP_CHECK_INTERVAL - 1)) == 0 && shouldStop()) {
+            searchAborted = true;
+            return 0;
+        }
+        
+        bool terminal;
+        {
+            SearchProfile::Timer timer(stats.profile, SearchProfile::WIN_CHECK);
+            terminal = isTerminalState(board, lastRow, lastCol);
+        }
+        if (terminal || depth <= 0) {
+            SearchProfile::Timer timer(stats.profile, SearchProfile::EVALUATION);
+            return aiToMove ? evaluateBoard(worker) : -evaluateBoard(worker);
+        }
+        
+        const std::uint64_t key = board.getHashKey() ^ (aiToMove ? 0 : Zobrist::sideKey());
+        int hashMove = TranspositionTable::NO_MOVE;
         
-        for (int dr = -3; dr <= 3; dr++) {
-            for (int dc = -3; dc <= 3; dc++) {
-                int r = centerRow + dr;
-                int c = centerCol + dc;
-                
-                if (r >= 0 && r < size && c >= 0 && c < size && board[r][c] == player) {
-                    int distance = std::abs(dr) + std::abs(dc);
-                    score += (4 - distance) * 10;
+        TranspositionTable::Entry entry;
+        if (transpositionTable->probe(key, entry)) {
+            stats.ttHits++;
+            hashMove = entry.move;
+            
+            if (entry.depth >= depth) {
+                if (entry.bound == TranspositionTable::BOUND_EXACT) {
+                    return entry.score;
+                }
+                if (entry.bound == TranspositionTable::BOUND_LOWER) {
+                    alpha = std::max(alpha, entry.score);
+                } else if (entry.bound == TranspositionTable::BOUND_UPPER) {
+                    beta = std::min(beta, entry.score);
+                }
+                if (alpha >= beta) {
+                    return entry.score;
                 }
             }
+        } else {
+            stats.ttMisses++;
         }
         
-        return score;
-    }
-    
-    int countInLine(const std::vector<std::vector<int>>& board, int row, int col, int dx, int dy, int player) {
-        int size = board.size();
-        int count = 0;
+        const int alphaOrig = alpha;
+        const int betaOrig = beta;
         
-        if (row >= 0 && row < size && col >= 0 && col < size && board[row][col] == player) {
-            count = 1;
+        std::vector<MoveEvaluation>& moves = worker.moveBuffers[ply];
+        {
+            SearchProfile::Timer timer(stats.profile, SearchProfile::CANDIDATE_GENERATION);
+            generateCandidateMoves(board, moves, worker.criticalScratch);
         }
+        if (moves.empty()) {
+            return aiToMove ? evaluateBoard(worker) : -evaluateBoard(worker);
+        }
+        
+        {
+            SearchProfile::Timer timer(stats.profile, SearchProfile::MOVE_ORDERING);
+            scoreMoves(worker, moves, ply, hashMove);
+        }
+        
+        const int player = aiToMove ? aiPlayer : humanPlayer;
+        int bestScore = -SCORE_INFINITY;
+        int bestMove = TranspositionTable::NO_MOVE;
+        size_t searched = 0;
         
-        int x = row + dx, y = col + dy;
-        while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-            count++;
-            x += dx;
-            y += dy;
+        for (size_t i = 0; i < moves.size(); i++) {
+            {
+                SearchProfile::Timer timer(stats.profile, SearchProfile::MOVE_ORDERING);
+                pickNextMove(moves, i);
+            }
+            const MoveEvaluation& move = moves[i];
+            const int extension = threatExtension(board, move.row, move.col, player, extensions);
+            const int childDepth = depth - 1 + extension;
+            int reduction = 0;
+            if (i >= LMR_FULL_DEPTH_MOVES && depth >= LMR_MIN_DEPTH && extension == 0 &&
+                isQuietMove(worker, move, ply, hashMove, player)) {
+                reduction = std::min(i >= LMR_DEEP_MOVES ? 2 : 1, childDepth - 1);
+            }
+            makeSearchMove(worker, move.row, move.col, player);
+            
+            int score;
+            if (i == 0) {
+                score = -negamax(worker, childDepth, ply + 1, extensions + extension, !aiToMove,
+                                 -beta, -alpha, move.row, move.col);
+            } else {
+                if (reduction > 0) {
+                    stats.reducedMoves++;
+                }
+                score = -negamax(worker, childDepth - reduction, ply + 1, extensions + extension, !aiToMove,
+                                 -alpha - 1, -alpha, move.row, move.col);
+                if (score > alpha && reduction > 0) {
+                    stats.researches++;
+                    score = -negamax(worker, childDepth, ply + 1, extensions + extension, !aiToMove,
+                                     -alpha - 1, -alpha, move.row, move.col);
+                }
+                if (score > alpha && score < beta) {
+                    stats.researches++;
+                    score = -negamax(worker, childDepth, ply + 1, extensions + extension, !aiToMove,
+                                     -beta, -alpha, move.row, move.col);
+                }
+            }
+            
+            undoSearchMove(worker);
+            
+            if (searchAborted.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+            searched++;
+            // Trace giữ góc nhìn của AI để cùng định dạng với nút gốc
+            traceNode(worker, ply, move, player, aiToMove ? alpha : -beta, aiToMove ? beta : -alpha,
+                      aiToMove ? score : -score, score >= beta);
+            
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = toMoveIndex(move.row, move.col);
+            }
+            alpha = std::max(alpha, score);
+            
+            if (alpha >= beta) {
+                stats.pruningCount++;
+                recordCutoff(worker, ply, move, depth);
+                break;
+            }
         }
+        stats.profile.recordExpansion(ply, static_cast<long long>(searched));
         
-        x = row - dx, y = col - dy;
-        while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-            count++;
-            x -= dx;
-            y -= dy;
+        TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+        if (bestScore <= alphaOrig) {
+            bound = TranspositionTable::BOUND_UPPER;
+        } else if (bestScore >= betaOrig) {
+            bound = TranspositionTable::BOUND_LOWER;
         }
+        transpositionTable->store(key, bestScore, depth, bound, bestMove);
         
-        return count;
+        return bestScore;
     }
     
-    bool hasAdjacentPieces(const std::vector<std::vector<int>>& board, int row, int col, int radius) {
-        int size = board.size();
+    static void finishStats(ThinkingStats& stats) {
+        if (stats.timeElapsed > 0.0) {
+            stats.nodesPerSecond = stats.nodesEvaluated / stats.timeElapsed;
+        }
+        int probes = stats.ttHits + stats.ttMisses;
+        if (probes > 0) {
+            stats.ttHitRate = static_cast<double>(stats.ttHits) / probes;
+        }
+        stats.effectiveBranchingFactor = stats.profile.effectiveBranchingFactor();
+    }
+    
+    void traceIteration(SearchWorker& worker, const MoveEvaluation& best, int depth,
+                        SearchClock::time_point startTime) {
+        SearchTraceSink::Iteration iteration;
+        iteration.depth = depth;
+        iteration.score = best.score;
+        iteration.nodes = worker.stats.nodesEvaluated;
+        iteration.seconds = std::chrono::duration<double>(SearchClock::now() - startTime).count();
+        iteration.pv = worker.pv;
+        iteration.pvLength = extractPrincipalVariation(worker, best, depth);
+        worker.trace->onIteration(iteration);
+    }
+    
+    /**
+     * PV = nước gốc rồi lần theo best move lưu trong table; đi thử trên board của worker
+     * (không qua evaluator, vì mọi nước đều được hoàn lại) và ghi vào worker.pv
+     */
+    int extractPrincipalVariation(SearchWorker& worker, const MoveEvaluation& best, int depth) {
+        Board& board = worker.board;
+        int length = 0;
+        int player = aiPlayer;
+        int row = best.row;
+        int col = best.col;
         
-        for (int dr = -radius; dr <= radius; dr++) {
-            for (int dc = -radius; dc <= radius; dc++) {
-                if (dr == 0 && dc == 0) continue;
-                
-                int nr = row + dr;
-                int nc = col + dc;
-                
-                if (nr >= 0 && nr < size && nc >= 0 && nc < size && board[nr][nc] != 0) {
-                    return true;
-                }
-            }
+        while (length < std::min(depth, static_cast<int>(MAX_PLY)) && board.isValidMove(row, col)) {
+            bool wins = board.makesFive(row, col, player);
+            board.makeMove(row, col, player);
+            worker.pv[length++] = toMoveIndex(row, col);
+            player = (player == 1) ? 2 : 1;
+            if (wins) break;
+            
+            TranspositionTable::Entry entry;
+            std::uint64_t key = board.getHashKey() ^ (player == aiPlayer ? 0 : Zobrist::sideKey());
+            if (!transpositionTable->probe(key, entry) || entry.move == TranspositionTable::NO_MOVE) break;
+            row = entry.move / Board::MAX_SIZE;
+            col = entry.move % Board::MAX_SIZE;
         }
         
+        for (int i = 0; i < length; i++) {
+            board.undoLastMove();
+        }
+        return length;
+    }
+    
+    /**
+     * Gửi một cạnh của cây cho trace sink; chỉ có khi build với CARO_SEARCH_PROFILE
+     */
+    void traceNode(const SearchWorker& worker, int ply, const MoveEvaluation& move, int player,
+                   int alpha, int beta, int score, bool cutoff) const {
+#if defined(CARO_SEARCH_PROFILE)
+        if (worker.trace) {
+            SearchTraceSink::Node node = {ply, toMoveIndex(move.row, move.col), player, alpha, beta, score, cutoff};
+            worker.trace->onNode(node);
+        }
+#else
+        (void)worker; (void)ply; (void)move; (void)player;
+        (void)alpha; (void)beta; (void)score; (void)cutoff;
+#endif
+    }
+    
+    static int toMoveIndex(int row, int col) {
+        return row * Board::MAX_SIZE + col;
+    }
+    
+    void makeSearchMove(SearchWorker& worker, int row, int col, int player) {
+        worker.board.makeMove(row, col, player);
+        worker.evaluator.update(worker.board, row, col);
+    }
+    
+    void undoSearchMove(SearchWorker& worker) {
+        int row = std::get<0>(worker.board.getLastMove());
+        int col = std::get<1>(worker.board.getLastMove());
+        worker.board.undoLastMove();
+        worker.evaluator.update(worker.board, row, col);
+    }
+    
+    bool isTerminalState(const Board& board, int lastRow, int lastCol) {
+        if (lastRow >= 0 && lastCol >= 0) {
+            return GameLogic::checkWinAtPosition(board, lastRow, lastCol, board.getCell(lastRow, lastCol));
+        }
         return false;
     }
     
-    MoveEvaluation getRandomMove(const std::vector<std::vector<int>>& board) {
-        int size = board.size();
+    int evaluateBoard(SearchWorker& worker) {
+        int aiScore = worker.evaluator.getScore(aiPlayer);
+        int humanScore = worker.evaluator.getScore(humanPlayer);
+        
+        int baseScore = aiScore - humanScore;
+        return evaluateWithStyle(worker, baseScore);
+    }
+    
+    bool usesPatternScore() const {
+        return playStyle == PlayStyle::AGGRESSIVE || playStyle == PlayStyle::DEFENSIVE;
+    }
+    
+    // Điểm pattern và trung tâm được evaluator giữ sẵn qua make/unmake nên style nào cũng O(1) ở lá
+    int evaluateWithStyle(const SearchWorker& worker, int baseScore) const {
+        switch (playStyle) {
+            case PlayStyle::AGGRESSIVE:
+                return baseScore + worker.evaluator.getPatternScore(aiPlayer) / 2;
+            case PlayStyle::DEFENSIVE:
+                return baseScore - worker.evaluator.getPatternScore(humanPlayer) / 2;
+            case PlayStyle::POSITIONAL:
+                return baseScore + worker.evaluator.getCenterScore(aiPlayer);
+            case PlayStyle::BALANCED:
+            default:
+                return baseScore;
+        }
+    }
+    
+    MoveEvaluation getRandomMove(const Board& board) {
+        const BoardView grid = board.getGrid();
+        int size = board.getSize();
         std::vector<MoveEvaluation> availableMoves;
         
         for (int i = 0; i < size; i++) {
             for (int j = 0; j < size; j++) {
-                if (board[i][j] == 0) {
+                if (grid[i][j] == 0) {
                     availableMoves.emplace_back(i, j);
                 }
             }
@@ -560,4 +1346,6 @@ private:
     }
 };
 
+const int AI::KILLER_SCORES[2] = {900000, 800000};
+
 #endif // AI_H
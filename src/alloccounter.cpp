@@ -0,0 +1,84 @@
+// alloccounter.cpp - Heap Allocation Counter
+// Người 1: Logic & AI - Đếm số lần cấp phát heap theo thread để kiểm tra search không gọi malloc
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @class AllocationCounter
+ * @brief Per-thread count of global operator new calls, enabled with -DCARO_COUNT_ALLOCATIONS
+ *
+ * Khi bật macro, file này thay operator new/delete toàn cục bằng bản gọi malloc/free
+ * và tăng bộ đếm của thread hiện tại. AI đọc bộ đếm trước và sau iterative deepening
+ * để báo ThinkingStats::searchAllocations; đường search nóng phải giữ con số này = 0.
+ * Không bật macro thì không thay gì và count() luôn trả 0.
+ *
+ * Chương trình là một translation unit nên các định nghĩa toàn cục bên dưới chỉ
+ * xuất hiện một lần nhờ include guard.
+ */
+class AllocationCounter {
+public:
+#if defined(CARO_COUNT_ALLOCATIONS)
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    static long long count() noexcept { return counter(); }
+    static void record() noexcept { counter()++; }
+
+private:
+    static long long& counter() noexcept {
+        static thread_local long long value = 0;    // Khởi tạo tĩnh, không tự cấp phát
+        return value;
+    }
+};
+
+#if defined(CARO_COUNT_ALLOCATIONS)
+
+namespace AllocationCounterDetail {
+    inline void* allocate(std::size_t size) {
+        AllocationCounter::record();
+        void* pointer = std::malloc(size ? size : 1);
+        if (!pointer) throw std::bad_alloc();
+        return pointer;
+    }
+
+    inline void* allocate(std::size_t size, std::align_val_t alignment) {
+        AllocationCounter::record();
+        std::size_t align = static_cast<std::size_t>(alignment);
+        void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align);
+        if (!pointer) throw std::bad_alloc();
+        return pointer;
+    }
+}
+
+void* operator new(std::size_t size) { return AllocationCounterDetail::allocate(size); }
+void* operator new[](std::size_t size) { return AllocationCounterDetail::allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocationCounterDetail::allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocationCounterDetail::allocate(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return AllocationCounterDetail::allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return AllocationCounterDetail::allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#endif // CARO_COUNT_ALLOCATIONS
+
+#endif // ALLOCCOUNTER_H
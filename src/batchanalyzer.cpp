@@ -0,0 +1,242 @@
+// batchanalyzer.cpp - Batch Position Analysis
+// Người 1: Logic & AI - Phân tích song song nhiều vị trí (offline) trên một nhóm thread
+#ifndef BATCHANALYZER_H
+#define BATCHANALYZER_H
+
+#include <vector>
+#include <tuple>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+
+#include "board.cpp"
+#include "zobrist.cpp"
+#include "symmetry.cpp"
+#include "ai.cpp"
+
+/**
+ * @class BatchAnalyzer
+ * @brief Runs AI::findBestMove over many positions on a fixed pool of worker threads
+ *
+ * Mỗi vị trí là kích thước bàn + lịch sử nước đi (đúng định dạng Board::getMoveHistory);
+ * bên sắp đi là người không đi nước cuối (người 1 nếu bàn trống).
+ *
+ * Mỗi worker sở hữu state riêng, không chia sẻ gì với worker khác nên không cần lock:
+ * - 2 AI (một cho mỗi bên), tạo khi cần, mỗi AI search 1 thread với table riêng
+ * - 1 Board nháp được reset và đi lại lịch sử cho từng vị trí thay vì cấp phát mới
+ * Worker lấy vị trí kế tiếp qua một chỉ số atomic và ghi kết quả vào đúng ô của nó,
+ * nên kết quả luôn theo thứ tự đầu vào bất kể vị trí nào xong trước.
+ *
+ * mergeSymmetric: các vị trí trùng nhau qua 8 phép đối xứng (cùng bên sắp đi, theo
+ * Board::getCanonicalKey) chỉ search một lần. Vị trí được search trong hệ chuẩn rồi nước
+ * được biến đổi ngược về hướng của từng vị trí, nên kết quả vẫn không phụ thuộc thứ tự đầu vào.
+ */
+class BatchAnalyzer {
+public:
+    using MoveHistory = std::vector<std::tuple<int, int, int>>;
+
+    struct Position {
+        int boardSize;
+        MoveHistory moves;                  // (row, col, player) theo thứ tự đã đi
+
+        Position(int size = Board::DEFAULT_SIZE, MoveHistory history = MoveHistory())
+            : boardSize(size), moves(std::move(history)) {}
+
+        static Position fromBoard(const Board& board) {
+            return Position(board.getSize(), board.getMoveHistory());
+        }
+    };
+
+    struct Config {
+        int workerCount;                    // 0 = std::thread::hardware_concurrency()
+        AI::Difficulty difficulty;
+        AI::PlayStyle playStyle;
+        std::chrono::milliseconds timeBudget;   // 0 = search theo depth của difficulty
+        size_t hashMegabytes;               // Kích thước table của mỗi AI
+        bool clearHashPerPosition;          // true: kết quả không phụ thuộc thứ tự xếp việc
+        bool mergeSymmetric;                // true: vị trí đối xứng với vị trí khác chỉ search một lần
+
+        Config() : workerCount(0), difficulty(AI::Difficulty::MEDIUM), playStyle(AI::PlayStyle::BALANCED),
+                   timeBudget(0), hashMegabytes(4), clearHashPerPosition(true), mergeSymmetric(false) {}
+    };
+
+    struct Report {
+        std::vector<AI::MoveEvaluation> moves;      // Theo thứ tự đầu vào; row = -1 nếu vị trí lỗi
+        std::vector<AI::ThinkingStats> stats;       // Stats của từng vị trí (rỗng nếu lấy từ vị trí đối xứng)
+        int failedPositions;                        // Lịch sử không hợp lệ hoặc ván đã hết chỗ
+        int mergedPositions;                        // Lấy kết quả của một vị trí đối xứng đã search
+        int workerCount;
+        double timeElapsed;                         // Giây, toàn bộ batch
+        double positionsPerSecond;
+        long long totalNodes;
+
+        Report() : failedPositions(0), mergedPositions(0), workerCount(0), timeElapsed(0.0),
+                   positionsPerSecond(0.0), totalNodes(0) {}
+    };
+
+    explicit BatchAnalyzer(const Config& config = Config()) : config(config) {}
+
+    void setConfig(const Config& newConfig) { config = newConfig; }
+    const Config& getConfig() const noexcept { return config; }
+
+    Report analyze(const std::vector<Position>& positions) const {
+        Report report;
+        report.moves.resize(positions.size());
+        report.stats.resize(positions.size());
+
+        auto startTime = std::chrono::steady_clock::now();
+        Plan plan = makePlan(positions);
+        report.mergedPositions = static_cast<int>(positions.size() - plan.tasks.size());
+
+        int workers = config.workerCount > 0 ? config.workerCount
+                                             : static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(1, std::min(workers, static_cast<int>(plan.tasks.size())));
+        report.workerCount = workers;
+
+        std::atomic<size_t> next(0);
+        std::atomic<int> failed(0);
+        std::vector<AI::MoveEvaluation> taskMoves(plan.tasks.size());
+
+        std::vector<std::thread> pool;
+        for (int i = 1; i < workers; i++) {
+            pool.emplace_back([&]() { runWorker(positions, plan.tasks, taskMoves, report, next, failed); });
+        }
+        runWorker(positions, plan.tasks, taskMoves, report, next, failed);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        // Nước tìm được ở hệ chuẩn của task -> hướng thật của từng vị trí dùng task đó
+        for (size_t i = 0; i < positions.size(); i++) {
+            AI::MoveEvaluation move = taskMoves[plan.taskOf[i]];
+            if (move.row >= 0) {
+                BoardSymmetry::apply(BoardSymmetry::inverse(plan.symmetryOf[i]), positions[i].boardSize,
+                                     move.row, move.col, move.row, move.col);
+            }
+            report.moves[i] = move;
+        }
+
+        report.timeElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        report.failedPositions = failed.load();
+        for (const auto& stats : report.stats) {
+            report.totalNodes += stats.nodesEvaluated;
+        }
+        if (report.timeElapsed > 0.0) {
+            report.positionsPerSecond = static_cast<double>(positions.size()) / report.timeElapsed;
+        }
+        return report;
+    }
+
+private:
+    Config config;
+
+    struct WorkerState {
+        Board board;
+        std::unique_ptr<AI> players[2];
+
+        AI& playerAI(int player, const Config& config) {
+            std::unique_ptr<AI>& ai = players[player - 1];
+            if (!ai) {
+                ai.reset(new AI(player, config.difficulty, config.playStyle,
+                                std::make_shared<TranspositionTable>(config.hashMegabytes)));
+            }
+            return *ai;
+        }
+    };
+
+    /**
+     * Một việc search: vị trí đại diện, đi lại trong hệ của phép đối xứng symmetry
+     */
+    struct Task {
+        size_t position;
+        int symmetry;
+    };
+
+    struct Plan {
+        std::vector<Task> tasks;
+        std::vector<size_t> taskOf;         // Vị trí i dùng kết quả của tasks[taskOf[i]]
+        std::vector<int> symmetryOf;        // Phép đưa vị trí i về hệ mà task của nó đã search
+    };
+
+    /**
+     * Không gộp: mỗi vị trí một task ở hướng gốc. Gộp: đi lại từng vị trí một lần để lấy khóa chuẩn
+     * (cộng sideKey theo bên sắp đi); vị trí lỗi hoặc đã đầy luôn có task riêng để worker đếm là failed
+     */
+    Plan makePlan(const std::vector<Position>& positions) const {
+        Plan plan;
+        plan.taskOf.resize(positions.size());
+        plan.symmetryOf.assign(positions.size(), BoardSymmetry::IDENTITY);
+
+        Board board;
+        std::unordered_map<std::uint64_t, size_t> taskByKey;
+        for (size_t i = 0; i < positions.size(); i++) {
+            if (config.mergeSymmetric && replay(positions[i], BoardSymmetry::IDENTITY, board) && !board.isFull()) {
+                int symmetry;
+                std::uint64_t key = board.getCanonicalKey(symmetry, toMove(board) == 2 ? Zobrist::sideKey() : 0);
+                plan.symmetryOf[i] = symmetry;
+
+                auto found = taskByKey.emplace(key, plan.tasks.size());
+                if (!found.second) {
+                    plan.taskOf[i] = found.first->second;
+                    continue;
+                }
+            }
+            plan.taskOf[i] = plan.tasks.size();
+            plan.tasks.push_back(Task{i, plan.symmetryOf[i]});
+        }
+        return plan;
+    }
+
+    static int toMove(const Board& board) {
+        int lastPlayer = std::get<2>(board.getLastMove());
+        return (lastPlayer == 1) ? 2 : 1;
+    }
+
+    void runWorker(const std::vector<Position>& positions, const std::vector<Task>& tasks,
+                   std::vector<AI::MoveEvaluation>& taskMoves, Report& report,
+                   std::atomic<size_t>& next, std::atomic<int>& failed) const {
+        WorkerState state;
+
+        for (size_t t = next.fetch_add(1); t < tasks.size(); t = next.fetch_add(1)) {
+            const Task& task = tasks[t];
+            if (!replay(positions[task.position], task.symmetry, state.board) || state.board.isFull()) {
+                failed.fetch_add(1);
+                continue;
+            }
+
+            AI& ai = state.playerAI(toMove(state.board), config);
+            if (config.clearHashPerPosition) {
+                ai.clearHash();
+            }
+
+            taskMoves[t] = (config.timeBudget.count() > 0)
+                         ? ai.findBestMove(state.board.getGrid(), config.timeBudget)
+                         : ai.findBestMove(state.board.getGrid());
+            report.stats[task.position] = ai.getLastThinkingStats();
+        }
+    }
+
+    /**
+     * Đi lại lịch sử vào board, mỗi nước qua phép đối xứng symmetry (giữ nguyên thứ tự nước)
+     */
+    static bool replay(const Position& position, int symmetry, Board& board) {
+        if (position.boardSize != board.getSize()) {
+            board.reset(position.boardSize);
+            if (board.getSize() != position.boardSize) return false;
+        } else {
+            board.reset();
+        }
+
+        for (const auto& [row, col, player] : position.moves) {
+            int r, c;
+            BoardSymmetry::apply(symmetry, position.boardSize, row, col, r, c);
+            if (!board.makeMove(r, c, player)) return false;
+        }
+        return true;
+    }
+};
+
+#endif // BATCHANALYZER_H
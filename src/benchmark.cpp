@@ -0,0 +1,472 @@
+// benchmark.cpp - Engine Benchmark Suite
+// Người 1: Logic & AI - Các kịch bản benchmark cố định seed, xuất JSON/CSV để so sánh giữa các bản phát hành
+//
+// Build: g++ -std=c++17 -O2 -pthread benchmark.cpp -o caro_bench
+// Usage: caro_bench [--format json|csv] [--suite all|search|perft|evaluation|wincheck]
+//                   [--positions N] [--seed S] [--perft-depth D] [--output FILE]
+
+// Bộ đếm cấp phát luôn bật trong benchmark để báo allocations mỗi nước
+#ifndef CARO_COUNT_ALLOCATIONS
+#define CARO_COUNT_ALLOCATIONS
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <iomanip>
+
+#include "alloccounter.cpp"
+#include "board.cpp"
+#include "gamelogic.cpp"
+#include "evaluator.cpp"
+#include "ai.cpp"
+
+/**
+ * @class Benchmark
+ * @brief Fixed-seed, reproducible engine scenarios with one flat result row per scenario
+ *
+ * Các suite:
+ * - search:     AI::findBestMove ở mọi Difficulty trên bàn 15/50/100 (thời gian, node, NPS,
+ *               depth, số lần cấp phát mỗi nước)
+ * - perft:      đếm lá của cây make/unmake trên tập ứng viên tới perftDepth (dừng ở nước tạo 5)
+ * - evaluation: IncrementalEvaluator::update/attach và GameLogic::evaluateBoard
+ * - wincheck:   Board::makesFive và GameLogic::checkWinAtPosition
+ *
+ * Vị trí được sinh bằng mt19937 với seed cố định và chỉ dùng raw output (không qua
+ * uniform_int_distribution, vốn khác nhau giữa các thư viện chuẩn), nên cùng seed cho
+ * cùng vị trí trên mọi máy. checksum của mỗi dòng chỉ phụ thuộc kết quả tính toán
+ * (nước đi, hash lá, điểm), không phụ thuộc thời gian: đổi checksum nghĩa là đổi hành vi.
+ */
+class Benchmark {
+public:
+    enum class Format { JSON, CSV };
+
+    static const std::uint64_t CHECKSUM_BASIS = 0xCBF29CE484222325ULL;      // FNV-1a offset basis
+
+    struct Options {
+        Format format;
+        std::string suite;                  // "all" hoặc tên một suite
+        int positions;                      // Số vị trí mỗi kích thước bàn
+        std::uint32_t seed;
+        int perftDepth;
+        std::string outputPath;             // Rỗng = stdout
+
+        Options() : format(Format::JSON), suite("all"), positions(3), seed(20240601u),
+                    perftDepth(3) {}
+    };
+
+    struct Result {
+        std::string suite;
+        std::string scenario;
+        int boardSize;
+        std::string difficulty;             // Rỗng nếu không phải suite search
+        long long iterations;               // Số phép đo (nước, lá, lần gọi)
+        double seconds;
+        double perSecond;                   // iterations / seconds
+        long long nodes;                    // Node search (search) hoặc lá (perft)
+        double allocationsPerOp;
+        int depth;
+        std::uint64_t checksum;
+
+        Result() : boardSize(0), iterations(0), seconds(0.0), perSecond(0.0), nodes(0),
+                   allocationsPerOp(0.0), depth(0), checksum(CHECKSUM_BASIS) {}
+    };
+
+    static const int BOARD_SIZES[3];
+    static const int MAX_PERFT_DEPTH = 8;
+    static const int STONES_PER_POSITION = 12;
+
+    explicit Benchmark(const Options& options) : options(options) {}
+
+    void run() {
+        results.clear();
+        for (int size : BOARD_SIZES) {
+            std::vector<Board> positions = makePositions(size);
+            if (wants("search"))     runSearch(positions);
+            if (wants("perft"))      runPerft(positions);
+            if (wants("evaluation")) runEvaluation(positions);
+            if (wants("wincheck"))   runWinCheck(positions);
+        }
+    }
+
+    const std::vector<Result>& getResults() const noexcept { return results; }
+
+    void write(std::ostream& out) const {
+        if (options.format == Format::CSV) {
+            writeCsv(out);
+        } else {
+            writeJson(out);
+        }
+    }
+
+    void writeJson(std::ostream& out) const {
+        out << "{\n  \"seed\": " << options.seed << ",\n  \"positions\": " << options.positions
+            << ",\n  \"perftDepth\": " << options.perftDepth << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            out << "    {\"suite\": \"" << r.suite << "\", \"scenario\": \"" << r.scenario
+                << "\", \"boardSize\": " << r.boardSize << ", \"difficulty\": \"" << r.difficulty
+                << "\", \"iterations\": " << r.iterations << ", \"seconds\": " << formatNumber(r.seconds)
+                << ", \"perSecond\": " << formatNumber(r.perSecond) << ", \"nodes\": " << r.nodes
+                << ", \"allocationsPerOp\": " << formatNumber(r.allocationsPerOp)
+                << ", \"depth\": " << r.depth << ", \"checksum\": \"" << formatChecksum(r.checksum) << "\"}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    void writeCsv(std::ostream& out) const {
+        out << "suite,scenario,board_size,difficulty,iterations,seconds,per_second,nodes,"
+               "allocations_per_op,depth,checksum\n";
+        for (const Result& r : results) {
+            out << r.suite << ',' << r.scenario << ',' << r.boardSize << ',' << r.difficulty << ','
+                << r.iterations << ',' << formatNumber(r.seconds) << ',' << formatNumber(r.perSecond) << ','
+                << r.nodes << ',' << formatNumber(r.allocationsPerOp) << ',' << r.depth << ','
+                << formatChecksum(r.checksum) << '\n';
+        }
+    }
+
+    /**
+     * @brief Đọc tham số dòng lệnh; false nếu tham số sai
+     */
+    static bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+
+            if (arg == "--format") {
+                if (value == "json") options.format = Format::JSON;
+                else if (value == "csv") options.format = Format::CSV;
+                else return false;
+            } else if (arg == "--suite") {
+                if (value != "all" && value != "search" && value != "perft" &&
+                    value != "evaluation" && value != "wincheck") return false;
+                options.suite = value;
+            } else if (arg == "--positions") {
+                options.positions = std::atoi(value.c_str());
+                if (options.positions <= 0) return false;
+            } else if (arg == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            } else if (arg == "--perft-depth") {
+                options.perftDepth = std::atoi(value.c_str());
+                if (options.perftDepth <= 0 || options.perftDepth > MAX_PERFT_DEPTH) return false;
+            } else if (arg == "--output") {
+                options.outputPath = value;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Options options;
+    std::vector<Result> results;
+
+    bool wants(const char* suite) const { return options.suite == "all" || options.suite == suite; }
+
+    static double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    static std::uint64_t mix(std::uint64_t checksum, std::uint64_t value) {
+        return (checksum ^ value) * 0x100000001B3ULL;     // FNV-1a theo từng giá trị
+    }
+
+    static std::string formatNumber(double value) {
+        std::ostringstream text;
+        text << std::setprecision(6) << value;
+        return text.str();
+    }
+
+    static std::string formatChecksum(std::uint64_t value) {
+        std::ostringstream text;
+        text << std::hex << std::setw(16) << std::setfill('0') << value;
+        return text.str();
+    }
+
+    void addResult(Result result) {
+        if (result.seconds > 0.0) {
+            result.perSecond = static_cast<double>(result.iterations) / result.seconds;
+        }
+        std::cerr << result.suite << '/' << result.scenario << ' ' << result.boardSize
+                  << (result.difficulty.empty() ? "" : " " + result.difficulty)
+                  << ": " << formatNumber(result.seconds) << "s" << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    /**
+     * @brief STONES_PER_POSITION quân xen kẽ trong cửa sổ 11x11 quanh tâm, không nước nào tạo 5;
+     *        người 1 luôn là bên sắp đi
+     */
+    std::vector<Board> makePositions(int size) const {
+        std::mt19937 rng(options.seed ^ (static_cast<std::uint32_t>(size) * 2654435761u));
+        std::vector<Board> positions;
+        const int window = 11;
+        const int origin = size / 2 - window / 2;
+
+        for (int p = 0; p < options.positions; p++) {
+            Board board(size);
+            int player = 1;
+            while (board.getMoveCount() < STONES_PER_POSITION) {
+                int row = origin + static_cast<int>(rng() % window);
+                int col = origin + static_cast<int>(rng() % window);
+                if (!board.isValidMove(row, col) || board.makesFive(row, col, player)) continue;
+                board.makeMove(row, col, player);
+                player = (player == 1) ? 2 : 1;
+            }
+            positions.push_back(board);
+        }
+        return positions;
+    }
+
+    // ================== SUITES ==================
+
+    void runSearch(const std::vector<Board>& positions) {
+        static const std::pair<AI::Difficulty, const char*> DIFFICULTIES[] = {
+            {AI::Difficulty::BEGINNER, "BEGINNER"}, {AI::Difficulty::EASY, "EASY"},
+            {AI::Difficulty::MEDIUM, "MEDIUM"}, {AI::Difficulty::HARD, "HARD"},
+            {AI::Difficulty::EXPERT, "EXPERT"}
+        };
+
+        for (const auto& [difficulty, name] : DIFFICULTIES) {
+            AI ai(1, difficulty);
+            Result result;
+            result.suite = "search";
+            result.scenario = "findBestMove";
+            result.boardSize = positions.front().getSize();
+            result.difficulty = name;
+
+            long long allocations = 0;
+            for (const Board& board : positions) {
+                ai.clearHash();
+                long long allocationsBefore = AllocationCounter::count();
+                auto start = Clock::now();
+                AI::MoveEvaluation move = ai.findBestMove(board.getGrid());
+                result.seconds += secondsSince(start);
+                allocations += AllocationCounter::count() - allocationsBefore;
+
+                const AI::ThinkingStats& stats = ai.getLastThinkingStats();
+                result.iterations++;
+                result.nodes += stats.nodesEvaluated;
+                result.depth = std::max(result.depth, stats.maxDepthReached);
+                result.checksum = mix(result.checksum, static_cast<std::uint64_t>(move.row * Board::MAX_SIZE + move.col));
+            }
+            result.allocationsPerOp = static_cast<double>(allocations) / result.iterations;
+            addResult(result);
+        }
+    }
+
+    void runPerft(const std::vector<Board>& positions) {
+        Result result;
+        result.suite = "perft";
+        result.scenario = "candidates-d" + std::to_string(options.perftDepth);
+        result.boardSize = positions.front().getSize();
+        result.depth = options.perftDepth;
+
+        std::vector<std::pair<int, int>> buffers[MAX_PERFT_DEPTH + 1];
+        long long allocations = 0;
+        for (const Board& position : positions) {
+            Board board(position);
+            long long allocationsBefore = AllocationCounter::count();
+            auto start = Clock::now();
+            result.nodes += perft(board, options.perftDepth, 1, buffers, result.checksum);
+            result.seconds += secondsSince(start);
+            allocations += AllocationCounter::count() - allocationsBefore;
+        }
+        result.iterations = result.nodes;
+        result.allocationsPerOp = result.nodes ? static_cast<double>(allocations) / result.nodes : 0.0;
+        addResult(result);
+    }
+
+    /**
+     * @brief Số lá ở độ sâu depth; nước tạo 5 kết thúc ván nên là lá
+     *
+     * Tập ứng viên đổi sau mỗi make/unmake nên được chép vào buffer của ply trước khi duyệt.
+     */
+    static long long perft(Board& board, int depth, int player,
+                           std::vector<std::pair<int, int>>* buffers, std::uint64_t& checksum) {
+        if (depth == 0) {
+            checksum = mix(checksum, board.getHashKey());
+            return 1;
+        }
+
+        std::vector<std::pair<int, int>>& moves = buffers[depth];
+        const auto& cells = board.getCandidateCells();
+        moves.assign(cells.begin(), cells.end());
+
+        long long leaves = 0;
+        for (const auto& [row, col] : moves) {
+            bool wins = board.makesFive(row, col, player);
+            board.makeMove(row, col, player);
+            if (wins) {
+                checksum = mix(checksum, board.getHashKey());
+                leaves++;
+            } else {
+                leaves += perft(board, depth - 1, (player == 1) ? 2 : 1, buffers, checksum);
+            }
+            board.undoLastMove();
+        }
+        return leaves;
+    }
+
+    void runEvaluation(const std::vector<Board>& positions) {
+        const int size = positions.front().getSize();
+        const long long cells = static_cast<long long>(size) * size;
+
+        // update: make + update + unmake + update trên một ô ứng viên chọn theo seed
+        {
+            Result result = makeResult("evaluation", "incremental-update", size);
+            std::mt19937 rng(options.seed);
+            const int updatesPerPosition = 100000;
+            for (const Board& position : positions) {
+                Board board(position);
+                IncrementalEvaluator evaluator;
+                evaluator.attach(board);
+                std::vector<std::pair<int, int>> moves(board.getCandidateCells().begin(),
+                                                       board.getCandidateCells().end());
+
+                measure(result, updatesPerPosition, [&]() {
+                    for (int i = 0; i < updatesPerPosition; i++) {
+                        const auto& [row, col] = moves[rng() % moves.size()];
+                        board.makeMove(row, col, 1);
+                        evaluator.update(board, row, col);
+                        result.checksum = mix(result.checksum, static_cast<std::uint64_t>(evaluator.getScore(1)));
+                        board.undoLastMove();
+                        evaluator.update(board, row, col);
+                    }
+                });
+            }
+            addResult(result);
+        }
+
+        // attach và evaluateBoard quét cả bàn: số lần gọi tỉ lệ nghịch với số ô
+        const int fullScans = static_cast<int>(std::max(10LL, 2000000 / cells));
+        {
+            Result result = makeResult("evaluation", "incremental-attach", size);
+            IncrementalEvaluator evaluator;
+            for (const Board& board : positions) {
+                measure(result, fullScans, [&]() {
+                    for (int i = 0; i < fullScans; i++) {
+                        evaluator.attach(board);
+                    }
+                });
+                result.checksum = mix(result.checksum, static_cast<std::uint64_t>(evaluator.getScore(2)));
+            }
+            addResult(result);
+        }
+        {
+            Result result = makeResult("evaluation", "gamelogic-evaluateBoard", size);
+            for (const Board& board : positions) {
+                int score = 0;
+                measure(result, fullScans, [&]() {
+                    for (int i = 0; i < fullScans; i++) {
+                        score = GameLogic::evaluateBoard(board.getGrid(), 1 + (i & 1));
+                    }
+                });
+                result.checksum = mix(result.checksum, static_cast<std::uint64_t>(score));
+            }
+            addResult(result);
+        }
+    }
+
+    void runWinCheck(const std::vector<Board>& positions) {
+        const int size = positions.front().getSize();
+        const int rounds = 20000;
+
+        // Ô trống: đặt thử có tạo 5 không
+        {
+            Result result = makeResult("wincheck", "board-makesFive", size);
+            for (const Board& board : positions) {
+                const auto& cells = board.getCandidateCells();
+                long long wins = 0;
+                measure(result, static_cast<long long>(rounds) * cells.size() * 2, [&]() {
+                    for (int i = 0; i < rounds; i++) {
+                        for (const auto& [row, col] : cells) {
+                            wins += board.makesFive(row, col, 1) + board.makesFive(row, col, 2);
+                        }
+                    }
+                });
+                result.checksum = mix(result.checksum, static_cast<std::uint64_t>(wins));
+            }
+            addResult(result);
+        }
+
+        // Ô có quân: kiểm tra thắng tại nước vừa đi
+        {
+            Result result = makeResult("wincheck", "gamelogic-checkWinAtPosition", size);
+            for (const Board& board : positions) {
+                const auto& stones = board.getOccupiedCells();
+                long long wins = 0;
+                measure(result, static_cast<long long>(rounds) * stones.size(), [&]() {
+                    for (int i = 0; i < rounds; i++) {
+                        for (const auto& [row, col] : stones) {
+                            wins += GameLogic::checkWinAtPosition(board, row, col, board.getCell(row, col));
+                        }
+                    }
+                });
+                result.checksum = mix(result.checksum, static_cast<std::uint64_t>(wins));
+            }
+            addResult(result);
+        }
+    }
+
+    static Result makeResult(const char* suite, const char* scenario, int boardSize) {
+        Result result;
+        result.suite = suite;
+        result.scenario = scenario;
+        result.boardSize = boardSize;
+        return result;
+    }
+
+    /**
+     * @brief Chạy body một lần, cộng thời gian, số phép đo và số lần cấp phát (trung bình theo phép đo)
+     */
+    template<typename Body>
+    static void measure(Result& result, long long iterations, Body body) {
+        long long allocationsBefore = AllocationCounter::count();
+        auto start = Clock::now();
+        body();
+        result.seconds += secondsSince(start);
+
+        double totalAllocations = result.allocationsPerOp * result.iterations +
+                                  static_cast<double>(AllocationCounter::count() - allocationsBefore);
+        result.iterations += iterations;
+        result.allocationsPerOp = result.iterations ? totalAllocations / result.iterations : 0.0;
+    }
+};
+
+const int Benchmark::BOARD_SIZES[3] = {15, 50, 100};
+
+int main(int argc, char** argv) {
+    Benchmark::Options options;
+    if (!Benchmark::parseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--format json|csv] [--suite all|search|perft|evaluation|wincheck]"
+                  << " [--positions N] [--seed S] [--perft-depth D] [--output FILE]" << std::endl;
+        return 2;
+    }
+
+    Benchmark benchmark(options);
+    benchmark.run();
+
+    if (options.outputPath.empty()) {
+        benchmark.write(std::cout);
+    } else {
+        std::ofstream file(options.outputPath);
+        if (!file) {
+            std::cerr << "Cannot write " << options.outputPath << std::endl;
+            return 1;
+        }
+        benchmark.write(file);
+    }
+    return 0;
+}
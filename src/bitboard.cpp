@@ -0,0 +1,241 @@
+// bitboard.cpp - Line Bitboards
+// Người 1: Logic & AI - Mask bit theo từng đường (hàng, cột, 2 đường chéo) cho mỗi người chơi
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @class LineBitboards
+ * @brief One bitset per player per direction, kept in sync by Board::makeMove/undoLastMove
+ *
+ * Mỗi đường trên bàn cờ (size hàng, size cột, 2*size-1 đường chéo mỗi hướng)
+ * được lưu thành một mask 128 bit, đủ cho MAX_SIZE = 100. Ô (row, col) ứng với
+ * một bit trên đúng một đường của mỗi hướng, và các ô liền nhau theo hướng đó
+ * là các bit liền nhau, nên kiểm tra 5 quân liên tiếp chỉ còn vài phép shift-AND.
+ *
+ * Direction index khớp với GameLogic::DIRECTIONS:
+ * 0 = ngang (0,1), 1 = dọc (1,0), 2 = chéo (1,1), 3 = chéo ngược (1,-1)
+ */
+class LineBitboards {
+public:
+    static const int MAX_LINE_LENGTH = 128;
+    static const int DIRECTION_COUNT = 4;
+    static const int WINDOW_RADIUS = 4;           // Cửa sổ 9 ô quanh một điểm
+
+    enum Direction {
+        HORIZONTAL = 0,
+        VERTICAL = 1,
+        DIAGONAL = 2,
+        ANTI_DIAGONAL = 3
+    };
+
+    struct LineMask {
+        std::uint64_t words[2];
+    };
+
+    explicit LineBitboards(int boardSize = 15) { reset(boardSize); }
+
+    /**
+     * @brief Xóa toàn bộ mask và cấp phát lại cho kích thước mới
+     */
+    void reset(int boardSize) {
+        size = boardSize;
+        for (int p = 0; p < 2; p++) {
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                int lineCount = (d < DIAGONAL) ? size : 2 * size - 1;
+                lines[p][d].assign(lineCount, LineMask{{0, 0}});
+            }
+        }
+    }
+
+    int getSize() const noexcept { return size; }
+
+    void set(int row, int col, int player) noexcept {
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            int bit = bitIndex(d, row, col);
+            lines[player - 1][d][lineIndex(d, row, col)].words[bit >> 6] |= std::uint64_t(1) << (bit & 63);
+        }
+    }
+
+    void clear(int row, int col, int player) noexcept {
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            int bit = bitIndex(d, row, col);
+            lines[player - 1][d][lineIndex(d, row, col)].words[bit >> 6] &= ~(std::uint64_t(1) << (bit & 63));
+        }
+    }
+
+    bool test(int row, int col, int player) const noexcept {
+        int bit = bitIndex(HORIZONTAL, row, col);
+        return (lines[player - 1][HORIZONTAL][row].words[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    /**
+     * @brief 9 bit quanh (row, col) theo hướng dir; bit WINDOW_RADIUS là chính ô đó
+     * Các ô ngoài bàn cờ đọc ra 0.
+     */
+    std::uint32_t window(int row, int col, int dir, int player) const noexcept {
+        const LineMask& mask = lines[player - 1][dir][lineIndex(dir, row, col)];
+        return static_cast<std::uint32_t>(bitsFrom(mask, bitIndex(dir, row, col) - WINDOW_RADIUS)) & 0x1FF;
+    }
+
+    /**
+     * @brief Các bit của window() ứng với ô nằm trong bàn cờ
+     */
+    std::uint32_t boardWindow(int row, int col, int dir) const noexcept {
+        int first = 0, last = size - 1;
+        if (dir == DIAGONAL) {
+            int offset = row - col;                     // bit = col
+            first = offset < 0 ? -offset : 0;
+            last = offset > 0 ? size - 1 - offset : size - 1;
+        } else if (dir == ANTI_DIAGONAL) {
+            int sum = row + col;                        // bit = row
+            first = sum > size - 1 ? sum - (size - 1) : 0;
+            last = sum < size - 1 ? sum : size - 1;
+        }
+
+        int pos = bitIndex(dir, row, col);
+        int low = pos - WINDOW_RADIUS > first ? pos - WINDOW_RADIUS : first;
+        int high = pos + WINDOW_RADIUS < last ? pos + WINDOW_RADIUS : last;
+        return ((1u << (high - low + 1)) - 1) << (low - (pos - WINDOW_RADIUS));
+    }
+
+    /**
+     * @brief Có 5 quân liên tiếp của player đi qua (row, col) theo hướng dir không
+     * @param extra Mask bổ sung vào cửa sổ (vd. 1 << WINDOW_RADIUS để thử một quân giả định)
+     */
+    bool hasFive(int row, int col, int dir, int player, std::uint32_t extra = 0) const noexcept {
+        std::uint32_t w = window(row, col, dir, player) | extra;
+        return (w & (w >> 1) & (w >> 2) & (w >> 3) & (w >> 4) & 0x1F) != 0;
+    }
+
+    bool hasFive(int row, int col, int player) const noexcept {
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            if (hasFive(row, col, d, player)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Số quân liên tiếp của player trên đường qua (row, col), tính cả ô giữa nếu có quân
+     */
+    int countInLine(int row, int col, int dir, int player) const noexcept {
+        const LineMask& mask = lines[player - 1][dir][lineIndex(dir, row, col)];
+        int pos = bitIndex(dir, row, col);
+        int count = static_cast<int>((mask.words[pos >> 6] >> (pos & 63)) & 1);
+
+        // Chiều dương: đếm số bit 1 liên tiếp từ pos + 1
+        for (int start = pos + 1; start < MAX_LINE_LENGTH; start += 64) {
+            int run = countTrailingOnes(bitsFrom(mask, start));
+            count += run;
+            if (run < 64) break;
+        }
+
+        // Chiều âm: đếm số bit 1 liên tiếp từ pos - 1 trở xuống
+        for (int end = pos; end > 0; end -= 64) {
+            int run = countLeadingOnes(bitsFrom(mask, end - 64));
+            count += run;
+            if (run < 64) break;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Map (dx, dy) về direction index; hướng ngược chiều dùng chung đường
+     * @return -1 nếu (dx, dy) không phải một trong 8 hướng đơn vị
+     */
+    static int directionIndex(int dx, int dy) noexcept {
+        if (dx < 0 || (dx == 0 && dy < 0)) {
+            dx = -dx;
+            dy = -dy;
+        }
+        if (dx == 0 && dy == 1) return HORIZONTAL;
+        if (dx == 1 && dy == 0) return VERTICAL;
+        if (dx == 1 && dy == 1) return DIAGONAL;
+        if (dx == 1 && dy == -1) return ANTI_DIAGONAL;
+        return -1;
+    }
+
+    size_t getMemoryUsage() const noexcept {
+        size_t usage = 0;
+        for (int p = 0; p < 2; p++) {
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                usage += lines[p][d].capacity() * sizeof(LineMask);
+            }
+        }
+        return usage;
+    }
+
+private:
+    int size;
+    std::vector<LineMask> lines[2][DIRECTION_COUNT];
+
+    int lineIndex(int dir, int row, int col) const noexcept {
+        switch (dir) {
+            case HORIZONTAL: return row;
+            case VERTICAL: return col;
+            case DIAGONAL: return row - col + size - 1;
+            default: return row + col;
+        }
+    }
+
+    static int bitIndex(int dir, int row, int col) noexcept {
+        return (dir == VERTICAL || dir == ANTI_DIAGONAL) ? row : col;
+    }
+
+    /**
+     * @brief 64 bit của đường bắt đầu từ vị trí start (có thể âm); ngoài đường đọc ra 0
+     */
+    static std::uint64_t bitsFrom(const LineMask& mask, int start) noexcept {
+        if (start >= MAX_LINE_LENGTH || start <= -64) return 0;
+        if (start < 0) return mask.words[0] << (-start);
+
+        int word = start >> 6;
+        int shift = start & 63;
+        std::uint64_t bits = mask.words[word] >> shift;
+        if (shift != 0 && word == 0) {
+            bits |= mask.words[1] << (64 - shift);
+        }
+        return bits;
+    }
+
+    static int countTrailingOnes(std::uint64_t bits) noexcept {
+        std::uint64_t inverted = ~bits;
+        if (inverted == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(inverted);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, inverted);
+        return static_cast<int>(index);
+#else
+        int count = 0;
+        while ((inverted & 1) == 0) { inverted >>= 1; count++; }
+        return count;
+#endif
+    }
+
+    static int countLeadingOnes(std::uint64_t bits) noexcept {
+        std::uint64_t inverted = ~bits;
+        if (inverted == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(inverted);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, inverted);
+        return 63 - static_cast<int>(index);
+#else
+        int count = 0;
+        while ((inverted >> 63) == 0) { inverted <<= 1; count++; }
+        return count;
+#endif
+    }
+};
+
+#endif // BITBOARD_H
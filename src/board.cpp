@@ -15,12 +15,19 @@
  * API CHO CÁC MODULE KHÁC:
  * - Graphics Module (Người 2): getCell(), getGrid(), getActiveBounds()
  * - GameController (Người 3): makeMove(), isValidMove(), getLastMove()
- * - AI System: getNeighborCells(), getActiveRegions(), optimized search
+ * - AI System: getCandidateCells(), getNeighborCells(), getActiveRegions(), optimized search
  * 
  * THUẬT TOÁN VÀ TỐI ƯU:
  * - Region-based search: O(active_area) thay vì O(n²)
  * - Memory optimization cho bàn cờ lớn
  * - Smart candidate generation cho AI
+ * - Line bitboards (bitboard.cpp): win/pattern check bằng shift-AND thay vì duyệt từng ô
+ * - Zobrist hash (zobrist.cpp) cập nhật O(1) mỗi make/unmake cho transposition table, cùng lúc với khóa của
+ *   7 ảnh đối xứng còn lại (symmetry.cpp) để opening book / batch analysis chuẩn hóa vị trí trong O(8)
+ * - Tập nước ứng viên (ô trống trong bán kính 2 quanh quân) cập nhật O(25) mỗi make/unmake (neighborCounts có viền sentinel,
+ *   vòng 5x5 sinh riêng cho 15x15 / 19x19 qua FixedSize)
+ * - Vùng hoạt động là mảng đếm tham chiếu phẳng, các danh sách theo dõi reserve đủ cả bàn: make/unmake không cấp phát heap
+ * - Undo là nghịch đảo O(1) của makeMove: pop occupiedCells, giảm đếm vùng, pop stack hình chữ nhật bao
  * =====================================================================================
  */
 
@@ -28,12 +35,58 @@
 #define BOARD_H
 
 #include <vector>
+#include <cstdint>
 #include <memory>
-#include <unordered_set>
 #include <algorithm>
 #include <stdexcept>
 #include <tuple>
 #include <string>
+#include <array>
+
+#include "bitboard.cpp"
+#include "zobrist.cpp"
+#include "symmetry.cpp"
+#include "fixedsize.cpp"
+
+// ================== BOARD VIEW ==================
+
+/**
+ * @brief View chỉ đọc lên grid phẳng (row-major) của Board
+ *
+ * Thay cho const std::vector<std::vector<int>>& trong AI, GameLogic và ConsoleGame.
+ * Chỉ gồm pointer + size nên copy rẻ; không sở hữu dữ liệu, chỉ hợp lệ
+ * khi Board gốc còn sống và chưa resize.
+ */
+class BoardView {
+public:
+    using Cell = std::uint8_t;
+    
+    BoardView() noexcept : cells(nullptr), size(0) {}
+    BoardView(const Cell* data, int boardSize) noexcept : cells(data), size(boardSize) {}
+    
+    int getSize() const noexcept { return size; }
+    const Cell* data() const noexcept { return cells; }
+    
+    /**
+     * @brief Truy cập hàng, cho phép viết view[row][col] như grid cũ (không kiểm tra biên)
+     */
+    const Cell* operator[](int row) const noexcept { return cells + static_cast<size_t>(row) * size; }
+    
+    bool isInBounds(int row, int col) const noexcept {
+        return row >= 0 && row < size && col >= 0 && col < size;
+    }
+    
+    /**
+     * @return Trạng thái ô, hoặc -1 nếu out of bounds
+     */
+    int getCell(int row, int col) const noexcept {
+        return isInBounds(row, col) ? cells[static_cast<size_t>(row) * size + col] : -1;
+    }
+
+private:
+    const Cell* cells;
+    int size;
+};
 
 class Board {
 public:
@@ -42,6 +95,9 @@ public:
     static const int MIN_SIZE = 15;
     static const int MAX_SIZE = 100;
     static const int DEFAULT_SIZE = 15;
+    static const int CANDIDATE_RADIUS = 2;     // Bán kính tập nước ứng viên quanh mỗi quân
+    static_assert(MAX_SIZE <= Zobrist::MAX_CELLS && MAX_SIZE <= LineBitboards::MAX_LINE_LENGTH,
+                  "Zobrist keys and line masks must cover MAX_SIZE");
     
     enum CellState {
         EMPTY = 0,
@@ -49,18 +105,36 @@ public:
         PLAYER2 = 2   // O
     };
     
+    using Cell = BoardView::Cell;
+    
 private:
     // ================== CORE DATA STRUCTURES ==================
     
     int size;                                    // Kích thước bàn cờ
-    std::vector<std::vector<int>> grid;          // Ma trận bàn cờ
+    std::vector<Cell> grid;                      // Ma trận bàn cờ phẳng, row-major
     int moveCount;                               // Số nước đi đã thực hiện
+    LineBitboards lineMasks;                     // Mask bit theo 4 hướng cho mỗi người chơi
+    // Zobrist hash của vị trí sau mỗi phép BoardSymmetry; [IDENTITY] là hash của chính vị trí
+    std::array<std::uint64_t, BoardSymmetry::COUNT> symmetryKeys;
     
     // Performance optimization structures
-    std::vector<std::pair<int, int>> occupiedCells;     // Cache các ô có quân
-    std::unordered_set<long long> activeRegions;        // Vùng hoạt động (10x10 regions)
+    std::vector<std::pair<int, int>> occupiedCells;     // Cache các ô có quân, theo thứ tự đặt
+    std::vector<std::uint16_t> activeRegions;           // Số quân kích hoạt mỗi vùng (10x10 regions), theo regionIndex
     static const int REGION_SIZE = 10;
     
+    struct Bounds {
+        int minRow, minCol, maxRow, maxCol;
+    };
+    std::vector<Bounds> boundsStack;                    // boundsStack[i] = hình chữ nhật bao occupiedCells[0..i]
+    
+    // Tập ứng viên: ô trống có ít nhất một quân trong bán kính CANDIDATE_RADIUS
+    // neighborCounts có viền CANDIDATE_RADIUS ô mỗi phía (xem paddedIndex); ô viền giữ
+    // giá trị >= BORDER_COUNT nên không bao giờ chạm mốc 0/1 và vòng cập nhật khỏi kẹp biên
+    std::vector<std::uint8_t> neighborCounts;           // Số quân trong bán kính, theo từng ô
+    static const int BORDER_COUNT = 128;                // > 24 ô lân cận, cộng thêm vẫn < 256
+    std::vector<std::pair<int, int>> candidateCells;    // Danh sách dày, thứ tự không cố định
+    std::vector<int> candidatePositions;                // Vị trí trong candidateCells, -1 nếu không có
+    
     // Move tracking
     int lastMoveRow, lastMoveCol, lastPlayer;
     std::vector<std::tuple<int, int, int>> moveHistory;  // History cho undo
@@ -74,6 +148,11 @@ public:
      */
     explicit Board(int boardSize = DEFAULT_SIZE);
     
+    /**
+     * @brief Dựng Board từ view (các quân được đặt lại theo thứ tự row-major)
+     */
+    explicit Board(const BoardView& view);
+    
     Board(const Board& other);
     Board& operator=(const Board& other);
     Board(Board&& other) noexcept;
@@ -101,16 +180,63 @@ public:
     int getCell(int row, int col) const noexcept;
     
     /**
-     * @brief Lấy reference chỉ đọc tới toàn bộ grid (cho Graphics)
+     * @brief Lấy view chỉ đọc tới toàn bộ grid (cho Graphics, AI, GameLogic)
+     * Không copy; mọi thay đổi phải đi qua makeMove/undoLastMove để cache luôn đồng bộ.
      */
-    const std::vector<std::vector<int>>& getGrid() const noexcept { return grid; }
+    BoardView getGrid() const noexcept { return BoardView(grid.data(), size); }
+    
+    int getMoveCount() const noexcept { return moveCount; }
     
     /**
-     * @brief Lấy reference có thể chỉnh sửa (cho AI calculations)
+     * @brief Mask bit theo hàng/cột/chéo, luôn đồng bộ với grid (cho win check và pattern check)
      */
-    std::vector<std::vector<int>>& getGrid() noexcept { return grid; }
+    const LineBitboards& getLineMasks() const noexcept { return lineMasks; }
     
-    int getMoveCount() const noexcept { return moveCount; }
+    /**
+     * @brief Zobrist hash của các quân trên bàn (và kích thước bàn), không gồm lượt đi
+     */
+    std::uint64_t getHashKey() const noexcept { return symmetryKeys[BoardSymmetry::IDENTITY]; }
+    
+    /**
+     * @brief Hash của vị trí sau phép đối xứng symmetry, giữ O(1) như getHashKey
+     */
+    std::uint64_t getSymmetryKey(int symmetry) const noexcept { return symmetryKeys[symmetry]; }
+    
+    /**
+     * @brief Khóa chuẩn: nhỏ nhất trong 8 khóa đối xứng sau khi XOR salt (vd. Zobrist::sideKey())
+     * @param symmetry Phép đối xứng đưa bàn về hệ chuẩn (hòa thì phép có chỉ số nhỏ nhất)
+     */
+    std::uint64_t getCanonicalKey(int& symmetry, std::uint64_t salt = 0) const noexcept {
+        std::uint64_t best = symmetryKeys[0] ^ salt;
+        symmetry = 0;
+        for (int s = 1; s < BoardSymmetry::COUNT; s++) {
+            std::uint64_t key = symmetryKeys[s] ^ salt;
+            if (key < best) {
+                best = key;
+                symmetry = s;
+            }
+        }
+        return best;
+    }
+    
+    /**
+     * @brief Có 5 quân liên tiếp của player đi qua (row, col) không (shift-AND trên bitboard)
+     */
+    bool hasFiveAt(int row, int col, int player) const noexcept {
+        return isInBounds(row, col) && grid[index(row, col)] == player &&
+               lineMasks.hasFive(row, col, player);
+    }
+    
+    /**
+     * @brief Đặt quân player vào ô trống (row, col) có tạo thành 5 không (không sửa board)
+     */
+    bool makesFive(int row, int col, int player) const noexcept {
+        if (!isValidMove(row, col)) return false;
+        for (int d = 0; d < LineBitboards::DIRECTION_COUNT; d++) {
+            if (lineMasks.hasFive(row, col, d, player, 1u << LineBitboards::WINDOW_RADIUS)) return true;
+        }
+        return false;
+    }
 
     // ================== MOVE OPERATIONS ==================
     
@@ -186,6 +312,17 @@ public:
      * @brief Lấy tất cả vị trí có quân (CACHED)
      */
     const std::vector<std::pair<int, int>>& getOccupiedCells() const noexcept { return occupiedCells; }
+    
+    /**
+     * @brief Ô trống trong bán kính CANDIDATE_RADIUS quanh ít nhất một quân (CACHED)
+     * Không trùng lặp; thứ tự thay đổi sau mỗi make/unmake, không dựa vào thứ tự này.
+     * Tham chiếu mất hiệu lực sau makeMove/undoLastMove.
+     */
+    const std::vector<std::pair<int, int>>& getCandidateCells() const noexcept { return candidateCells; }
+    
+    bool isCandidateCell(int row, int col) const noexcept {
+        return isInBounds(row, col) && candidatePositions[index(row, col)] >= 0;
+    }
 
     // ================== REGION-BASED OPTIMIZATION ==================
     
@@ -235,10 +372,29 @@ public:
 private:
     // ================== INTERNAL HELPERS ==================
     
+    size_t index(int row, int col) const noexcept { return static_cast<size_t>(row) * size + col; }
+    int paddedStride() const noexcept { return size + 2 * CANDIDATE_RADIUS; }
+    size_t paddedIndex(int row, int col) const noexcept {
+        return static_cast<size_t>(row + CANDIDATE_RADIUS) * paddedStride() + col + CANDIDATE_RADIUS;
+    }
     long long getRegionKey(int row, int col) const noexcept;
-    void addActiveRegion(int row, int col);
+    int regionsPerSide() const noexcept { return (size + REGION_SIZE - 1) / REGION_SIZE; }
+    size_t regionIndex(int row, int col) const noexcept {
+        return static_cast<size_t>(row / REGION_SIZE) * regionsPerSide() + col / REGION_SIZE;
+    }
+    void reserveTracking();
+    void addActiveRegion(int row, int col, int delta = +1);
+    void pushBounds(int row, int col);
+    void rebuildBounds();
     void removeOccupiedCell(int row, int col);
     void updateActiveRegions();
+    void toggleSymmetryKeys(int row, int col, int player) noexcept;
+    void updateNeighborCounts(int row, int col, int delta);
+    template<int N> void updateNeighborCountsSized(int row, int col, int delta);
+    void resetNeighborCounts();
+    void addCandidate(int row, int col);
+    void removeCandidate(int row, int col);
+    void rebuildCandidates();
     void initializeBoard();
 };
 
@@ -247,7 +403,7 @@ private:
 // =====================================================================================
 
 Board::Board(int boardSize) 
-    : size(boardSize), moveCount(0), lastMoveRow(-1), lastMoveCol(-1), lastPlayer(-1) {
+    : size(boardSize), moveCount(0), symmetryKeys(), lastMoveRow(-1), lastMoveCol(-1), lastPlayer(-1) {
     
     if (!isValidSize(boardSize)) {
         size = DEFAULT_SIZE;
@@ -256,11 +412,32 @@ Board::Board(int boardSize)
     initializeBoard();
 }
 
+Board::Board(const BoardView& view)
+    : size(view.getSize()), moveCount(0), symmetryKeys(), lastMoveRow(-1), lastMoveCol(-1), lastPlayer(-1) {
+    
+    if (!isValidSize(size)) {
+        throw std::invalid_argument("Invalid board size " + std::to_string(size));
+    }
+    
+    initializeBoard();
+    
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            int cell = view[i][j];
+            if (cell != EMPTY) {
+                makeMove(i, j, cell);
+            }
+        }
+    }
+}
+
 Board::Board(const Board& other) 
-    : size(other.size), grid(other.grid), moveCount(other.moveCount),
-      occupiedCells(other.occupiedCells), activeRegions(other.activeRegions),
-      lastMoveRow(other.lastMoveRow), lastMoveCol(other.lastMoveCol),
+    : size(other.size), grid(other.grid), moveCount(other.moveCount), lineMasks(other.lineMasks),
+      symmetryKeys(other.symmetryKeys), occupiedCells(other.occupiedCells), activeRegions(other.activeRegions),
+      boundsStack(other.boundsStack), neighborCounts(other.neighborCounts), candidateCells(other.candidateCells),
+      candidatePositions(other.candidatePositions), lastMoveRow(other.lastMoveRow), lastMoveCol(other.lastMoveCol),
       lastPlayer(other.lastPlayer), moveHistory(other.moveHistory) {
+    reserveTracking();
 }
 
 Board& Board::operator=(const Board& other) {
@@ -268,20 +445,29 @@ Board& Board::operator=(const Board& other) {
         size = other.size;
         grid = other.grid;
         moveCount = other.moveCount;
+        lineMasks = other.lineMasks;
+        symmetryKeys = other.symmetryKeys;
         occupiedCells = other.occupiedCells;
         activeRegions = other.activeRegions;
+        boundsStack = other.boundsStack;
+        neighborCounts = other.neighborCounts;
+        candidateCells = other.candidateCells;
+        candidatePositions = other.candidatePositions;
         lastMoveRow = other.lastMoveRow;
         lastMoveCol = other.lastMoveCol;
         lastPlayer = other.lastPlayer;
         moveHistory = other.moveHistory;
+        reserveTracking();
     }
     return *this;
 }
 
 Board::Board(Board&& other) noexcept
     : size(other.size), grid(std::move(other.grid)), moveCount(other.moveCount),
+      lineMasks(std::move(other.lineMasks)), symmetryKeys(other.symmetryKeys),
       occupiedCells(std::move(other.occupiedCells)), activeRegions(std::move(other.activeRegions)),
-      lastMoveRow(other.lastMoveRow), lastMoveCol(other.lastMoveCol),
+      boundsStack(std::move(other.boundsStack)), neighborCounts(std::move(other.neighborCounts)), candidateCells(std::move(other.candidateCells)),
+      candidatePositions(std::move(other.candidatePositions)), lastMoveRow(other.lastMoveRow), lastMoveCol(other.lastMoveCol),
       lastPlayer(other.lastPlayer), moveHistory(std::move(other.moveHistory)) {
     
     other.size = DEFAULT_SIZE;
@@ -294,8 +480,14 @@ Board& Board::operator=(Board&& other) noexcept {
         size = other.size;
         grid = std::move(other.grid);
         moveCount = other.moveCount;
+        lineMasks = std::move(other.lineMasks);
+        symmetryKeys = other.symmetryKeys;
         occupiedCells = std::move(other.occupiedCells);
         activeRegions = std::move(other.activeRegions);
+        boundsStack = std::move(other.boundsStack);
+        neighborCounts = std::move(other.neighborCounts);
+        candidateCells = std::move(other.candidateCells);
+        candidatePositions = std::move(other.candidatePositions);
         lastMoveRow = other.lastMoveRow;
         lastMoveCol = other.lastMoveCol;
         lastPlayer = other.lastPlayer;
@@ -310,9 +502,14 @@ Board& Board::operator=(Board&& other) noexcept {
 
 void Board::initializeBoard() {
     try {
-        grid.assign(size, std::vector<int>(size, EMPTY));
-        occupiedCells.reserve(size * size / 4);  // Reserve 25% capacity
-        moveHistory.reserve(size * size);
+        grid.assign(static_cast<size_t>(size) * size, EMPTY);
+        lineMasks.reset(size);
+        symmetryKeys.fill(Zobrist::sizeKey(size));
+        resetNeighborCounts();
+        candidatePositions.assign(static_cast<size_t>(size) * size, -1);
+        candidateCells.clear();
+        activeRegions.assign(static_cast<size_t>(regionsPerSide()) * regionsPerSide(), 0);
+        reserveTracking();
     } catch (const std::bad_alloc&) {
         throw std::runtime_error("Failed to allocate memory for board of size " + std::to_string(size));
     }
@@ -328,19 +525,29 @@ bool Board::resize(int newSize) {
     }
     
     try {
-        std::vector<std::vector<int>> newGrid(newSize, std::vector<int>(newSize, EMPTY));
+        std::vector<Cell> newGrid(static_cast<size_t>(newSize) * newSize, EMPTY);
         
         // Copy existing data
         int copySize = std::min(size, newSize);
         for (int i = 0; i < copySize; i++) {
-            for (int j = 0; j < copySize; j++) {
-                newGrid[i][j] = grid[i][j];
-            }
+            std::copy_n(grid.begin() + index(i, 0), copySize,
+                        newGrid.begin() + static_cast<size_t>(i) * newSize);
         }
         
         grid = std::move(newGrid);
         size = newSize;
         
+        lineMasks.reset(size);
+        symmetryKeys.fill(Zobrist::sizeKey(size));
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                if (grid[index(i, j)] != EMPTY) {
+                    lineMasks.set(i, j, grid[index(i, j)]);
+                    toggleSymmetryKeys(i, j, grid[index(i, j)]);
+                }
+            }
+        }
+        
         // Clean up out-of-bounds data
         occupiedCells.erase(
             std::remove_if(occupiedCells.begin(), occupiedCells.end(),
@@ -351,6 +558,9 @@ bool Board::resize(int newSize) {
         );
         
         updateActiveRegions();
+        rebuildBounds();
+        rebuildCandidates();
+        reserveTracking();
         return true;
         
     } catch (const std::bad_alloc&) {
@@ -366,11 +576,11 @@ int Board::getCell(int row, int col) const noexcept {
     if (!isInBounds(row, col)) {
         return -1;  // Out of bounds
     }
-    return grid[row][col];
+    return grid[index(row, col)];
 }
 
 bool Board::isValidMove(int row, int col) const noexcept {
-    return isInBounds(row, col) && grid[row][col] == EMPTY;
+    return isInBounds(row, col) && grid[index(row, col)] == EMPTY;
 }
 
 bool Board::makeMove(int row, int col, int player) {
@@ -380,7 +590,9 @@ bool Board::makeMove(int row, int col, int player) {
     }
     
     // Update board state
-    grid[row][col] = player;
+    grid[index(row, col)] = static_cast<Cell>(player);
+    lineMasks.set(row, col, player);
+    toggleSymmetryKeys(row, col, player);
     moveCount++;
     
     // Update tracking
@@ -393,7 +605,10 @@ bool Board::makeMove(int row, int col, int player) {
     
     // Update optimization structures
     occupiedCells.emplace_back(row, col);
+    pushBounds(row, col);
     addActiveRegion(row, col);
+    removeCandidate(row, col);
+    updateNeighborCounts(row, col, +1);
     
     return true;
 }
@@ -407,12 +622,19 @@ bool Board::undoLastMove() {
     auto [row, col, player] = moveHistory.back();
     
     // Revert board state
-    grid[row][col] = EMPTY;
+    grid[index(row, col)] = EMPTY;
+    lineMasks.clear(row, col, player);
+    toggleSymmetryKeys(row, col, player);
     moveCount--;
     
     // Remove from structures
     moveHistory.pop_back();
     removeOccupiedCell(row, col);
+    addActiveRegion(row, col, -1);
+    updateNeighborCounts(row, col, -1);
+    if (neighborCounts[paddedIndex(row, col)] > 0) {
+        addCandidate(row, col);
+    }
     
     // Update last move tracking
     if (moveHistory.empty()) {
@@ -424,7 +646,6 @@ bool Board::undoLastMove() {
         lastPlayer = prevPlayer;
     }
     
-    updateActiveRegions();
     return true;
 }
 
@@ -451,9 +672,9 @@ bool Board::isEmpty() const noexcept {
 
 void Board::reset() {
     // Clear grid
-    for (auto& row : grid) {
-        std::fill(row.begin(), row.end(), EMPTY);
-    }
+    std::fill(grid.begin(), grid.end(), EMPTY);
+    lineMasks.reset(size);
+    symmetryKeys.fill(Zobrist::sizeKey(size));
     
     // Reset counters and tracking
     moveCount = 0;
@@ -461,8 +682,12 @@ void Board::reset() {
     
     // Clear optimization structures
     occupiedCells.clear();
-    activeRegions.clear();
+    std::fill(activeRegions.begin(), activeRegions.end(), 0);
+    boundsStack.clear();
     moveHistory.clear();
+    resetNeighborCounts();
+    std::fill(candidatePositions.begin(), candidatePositions.end(), -1);
+    candidateCells.clear();
 }
 
 void Board::reset(int newSize) {
@@ -477,7 +702,7 @@ std::vector<std::pair<int, int>> Board::getEmptyCells() const {
     
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
-            if (grid[i][j] == EMPTY) {
+            if (grid[index(i, j)] == EMPTY) {
                 emptyCells.emplace_back(i, j);
             }
         }
@@ -499,7 +724,7 @@ std::vector<std::pair<int, int>> Board::getEmptyCellsInRegion(
     
     for (int i = startRow; i < endRow; i++) {
         for (int j = startCol; j < endCol; j++) {
-            if (grid[i][j] == EMPTY) {
+            if (grid[index(i, j)] == EMPTY) {
                 emptyCells.emplace_back(i, j);
             }
         }
@@ -518,7 +743,7 @@ std::vector<std::pair<int, int>> Board::getNeighborCells(int row, int col, int r
     
     for (int i = startRow; i < endRow; i++) {
         for (int j = startCol; j < endCol; j++) {
-            if (grid[i][j] == EMPTY && (i != row || j != col)) {
+            if (grid[index(i, j)] == EMPTY && (i != row || j != col)) {
                 neighbors.emplace_back(i, j);
             }
         }
@@ -528,26 +753,28 @@ std::vector<std::pair<int, int>> Board::getNeighborCells(int row, int col, int r
 }
 
 std::vector<long long> Board::getActiveRegions() const {
-    return std::vector<long long>(activeRegions.begin(), activeRegions.end());
+    std::vector<long long> regions;
+    int perSide = regionsPerSide();
+    
+    for (int regionRow = 0; regionRow < perSide; regionRow++) {
+        for (int regionCol = 0; regionCol < perSide; regionCol++) {
+            if (activeRegions[static_cast<size_t>(regionRow) * perSide + regionCol]) {
+                regions.push_back(getRegionKey(regionRow * REGION_SIZE, regionCol * REGION_SIZE));
+            }
+        }
+    }
+    
+    return regions;
 }
 
 std::pair<std::pair<int, int>, std::pair<int, int>> Board::getActiveBounds() const {
-    if (occupiedCells.empty()) {
+    if (boundsStack.empty()) {
         auto center = getBoardCenter();
         return {{center.first, center.second}, {center.first, center.second}};
     }
     
-    int minRow = size, maxRow = -1;
-    int minCol = size, maxCol = -1;
-    
-    for (const auto& [row, col] : occupiedCells) {
-        minRow = std::min(minRow, row);
-        maxRow = std::max(maxRow, row);
-        minCol = std::min(minCol, col);
-        maxCol = std::max(maxCol, col);
-    }
-    
-    return {{minRow, minCol}, {maxRow, maxCol}};
+    const Bounds& bounds = boundsStack.back();
+    return {{bounds.minRow, bounds.minCol}, {bounds.maxRow, bounds.maxCol}};
 }
 
 std::pair<int, int> Board::getBoardCenter() const noexcept {
@@ -567,7 +794,7 @@ std::vector<std::pair<int, int>> Board::getCellsInRegion(long long regionKey) co
     
     for (int i = startRow; i < endRow; i++) {
         for (int j = startCol; j < endCol; j++) {
-            if (grid[i][j] != EMPTY) {
+            if (grid[index(i, j)] != EMPTY) {
                 cells.emplace_back(i, j);
             }
         }
@@ -582,30 +809,101 @@ double Board::getOccupancyRate() const noexcept {
 
 size_t Board::getMemoryUsage() const noexcept {
     size_t usage = sizeof(*this);
-    usage += grid.size() * sizeof(std::vector<int>);
-    usage += static_cast<long long>(size) * size * sizeof(int);
+    usage += grid.capacity() * sizeof(Cell);
+    usage += lineMasks.getMemoryUsage();
     usage += occupiedCells.capacity() * sizeof(std::pair<int, int>);
-    usage += activeRegions.size() * sizeof(long long);
+    usage += activeRegions.capacity() * sizeof(std::uint16_t);
+    usage += boundsStack.capacity() * sizeof(Bounds);
+    usage += neighborCounts.capacity() * sizeof(std::uint8_t);
+    usage += candidateCells.capacity() * sizeof(std::pair<int, int>);
+    usage += candidatePositions.capacity() * sizeof(int);
     usage += moveHistory.capacity() * sizeof(std::tuple<int, int, int>);
     return usage;
 }
 
 void Board::optimizeMemory() {
     occupiedCells.shrink_to_fit();
+    candidateCells.shrink_to_fit();
     moveHistory.shrink_to_fit();
+    boundsStack.shrink_to_fit();
     updateActiveRegions();
 }
 
 bool Board::validateState() const noexcept {
     // Check move count consistency
     int actualMoves = 0;
-    for (const auto& row : grid) {
-        for (int cell : row) {
-            if (cell != EMPTY) actualMoves++;
+    int actualCandidates = 0;
+    std::array<std::uint64_t, BoardSymmetry::COUNT> actualKeys;
+    actualKeys.fill(Zobrist::sizeKey(size));
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            Cell cell = grid[index(i, j)];
+            if (cell != EMPTY) {
+                actualMoves++;
+                for (int s = 0; s < BoardSymmetry::COUNT; s++) {
+                    int r, c;
+                    BoardSymmetry::apply(s, size, i, j, r, c);
+                    actualKeys[s] ^= Zobrist::piece(r, c, cell);
+                }
+            }
+            
+            // Bitboard phải khớp với grid
+            if (lineMasks.test(i, j, PLAYER1) != (cell == PLAYER1) ||
+                lineMasks.test(i, j, PLAYER2) != (cell == PLAYER2)) {
+                return false;
+            }
+            
+            // Tập ứng viên phải khớp với số quân trong bán kính
+            int stones = 0;
+            for (int r = std::max(0, i - CANDIDATE_RADIUS); r <= std::min(size - 1, i + CANDIDATE_RADIUS); r++) {
+                for (int c = std::max(0, j - CANDIDATE_RADIUS); c <= std::min(size - 1, j + CANDIDATE_RADIUS); c++) {
+                    if ((r != i || c != j) && grid[index(r, c)] != EMPTY) stones++;
+                }
+            }
+            bool candidate = cell == EMPTY && stones > 0;
+            if (neighborCounts[paddedIndex(i, j)] != stones || (candidatePositions[index(i, j)] >= 0) != candidate) {
+                return false;
+            }
+            actualCandidates += candidate ? 1 : 0;
         }
     }
     
-    return actualMoves == moveCount && 
+    // Stack bounds và số đếm vùng phải khớp với việc dựng lại từ occupiedCells
+    if (boundsStack.size() != occupiedCells.size()) {
+        return false;
+    }
+    if (!occupiedCells.empty()) {
+        Bounds actual = {size, size, -1, -1};
+        for (const auto& [row, col] : occupiedCells) {
+            actual.minRow = std::min(actual.minRow, row);
+            actual.minCol = std::min(actual.minCol, col);
+            actual.maxRow = std::max(actual.maxRow, row);
+            actual.maxCol = std::max(actual.maxCol, col);
+        }
+        const Bounds& tracked = boundsStack.back();
+        if (actual.minRow != tracked.minRow || actual.minCol != tracked.minCol ||
+            actual.maxRow != tracked.maxRow || actual.maxCol != tracked.maxCol) {
+            return false;
+        }
+    }
+    for (size_t region = 0; region < activeRegions.size(); region++) {
+        int count = 0;
+        for (const auto& [row, col] : occupiedCells) {
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    int r = row + dr * REGION_SIZE;
+                    int c = col + dc * REGION_SIZE;
+                    if (isInBounds(r, c) && regionIndex(r, c) == region) count++;
+                }
+            }
+        }
+        if (activeRegions[region] != count) {
+            return false;
+        }
+    }
+    
+    return actualMoves == moveCount && actualKeys == symmetryKeys &&
+           candidateCells.size() == static_cast<size_t>(actualCandidates) &&
            occupiedCells.size() == static_cast<size_t>(moveCount) &&
            moveHistory.size() == static_cast<size_t>(moveCount);
 }
@@ -618,31 +916,161 @@ long long Board::getRegionKey(int row, int col) const noexcept {
     return (static_cast<long long>(regionRow) << 32) | static_cast<unsigned int>(regionCol);
 }
 
-void Board::addActiveRegion(int row, int col) {
-    // Add current region and adjacent regions
+void Board::addActiveRegion(int row, int col, int delta) {
+    // Current region and adjacent regions; delta = -1 khi nhấc quân
     for (int dr = -1; dr <= 1; dr++) {
         for (int dc = -1; dc <= 1; dc++) {
             int r = row + dr * REGION_SIZE;
             int c = col + dc * REGION_SIZE;
             if (isInBounds(r, c)) {
-                activeRegions.insert(getRegionKey(r, c));
+                std::uint16_t& count = activeRegions[regionIndex(r, c)];
+                count = static_cast<std::uint16_t>(count + delta);
             }
         }
     }
 }
 
 void Board::removeOccupiedCell(int row, int col) {
+    // Undo luôn nhấc quân đặt sau cùng nên thường là pop; chỉ sau resize thu nhỏ
+    // (đã lọc bớt occupiedCells) mới phải tìm tuyến tính và dựng lại bounds
+    if (!occupiedCells.empty() && occupiedCells.back() == std::make_pair(row, col)) {
+        occupiedCells.pop_back();
+        boundsStack.pop_back();
+        return;
+    }
+    
     auto it = std::find(occupiedCells.begin(), occupiedCells.end(), std::make_pair(row, col));
     if (it != occupiedCells.end()) {
         occupiedCells.erase(it);
+        rebuildBounds();
+    }
+}
+
+void Board::pushBounds(int row, int col) {
+    Bounds bounds = {row, col, row, col};
+    if (!boundsStack.empty()) {
+        const Bounds& previous = boundsStack.back();
+        bounds.minRow = std::min(previous.minRow, row);
+        bounds.minCol = std::min(previous.minCol, col);
+        bounds.maxRow = std::max(previous.maxRow, row);
+        bounds.maxCol = std::max(previous.maxCol, col);
+    }
+    boundsStack.push_back(bounds);
+}
+
+void Board::rebuildBounds() {
+    boundsStack.clear();
+    for (const auto& [row, col] : occupiedCells) {
+        pushBounds(row, col);
     }
 }
 
 void Board::updateActiveRegions() {
-    activeRegions.clear();
+    activeRegions.assign(static_cast<size_t>(regionsPerSide()) * regionsPerSide(), 0);
     for (const auto& [row, col] : occupiedCells) {
         addActiveRegion(row, col);
     }
 }
 
+void Board::reserveTracking() {
+    // Đủ chỗ cho cả bàn để makeMove trong search không bao giờ phải cấp phát lại;
+    // copy của vector chỉ giữ capacity bằng size nên phải gọi lại sau khi copy
+    size_t cells = static_cast<size_t>(size) * size;
+    occupiedCells.reserve(cells);
+    boundsStack.reserve(cells);
+    moveHistory.reserve(cells);
+    candidateCells.reserve(cells);
+}
+
+/**
+ * XOR quân (row, col) vào khóa của cả 8 ảnh; cùng thứ tự với BoardSymmetry::apply
+ * (validateState kiểm tra lại bằng apply), viết thẳng để make/unmake không phải lặp
+ */
+inline void Board::toggleSymmetryKeys(int row, int col, int player) noexcept {
+    const std::uint64_t* keys = Zobrist::pieces();
+    const int flipRow = size - 1 - row;
+    const int flipCol = size - 1 - col;
+    symmetryKeys[0] ^= keys[Zobrist::pieceIndex(row, col, player)];
+    symmetryKeys[1] ^= keys[Zobrist::pieceIndex(flipRow, col, player)];
+    symmetryKeys[2] ^= keys[Zobrist::pieceIndex(row, flipCol, player)];
+    symmetryKeys[3] ^= keys[Zobrist::pieceIndex(flipRow, flipCol, player)];
+    symmetryKeys[4] ^= keys[Zobrist::pieceIndex(col, row, player)];
+    symmetryKeys[5] ^= keys[Zobrist::pieceIndex(flipCol, row, player)];
+    symmetryKeys[6] ^= keys[Zobrist::pieceIndex(col, flipRow, player)];
+    symmetryKeys[7] ^= keys[Zobrist::pieceIndex(flipCol, flipRow, player)];
+}
+
+void Board::updateNeighborCounts(int row, int col, int delta) {
+    FixedSize::dispatch(size, [&](auto fixed) {
+        updateNeighborCountsSized<decltype(fixed)::value>(row, col, delta);
+    });
+}
+
+template<int N>
+void Board::updateNeighborCountsSized(int row, int col, int delta) {
+    const int n = FixedSize::resolve<N>(size);
+    const std::ptrdiff_t stride = n + 2 * CANDIDATE_RADIUS;
+    std::uint8_t* center = neighborCounts.data() + paddedIndex(row, col);
+    const int threshold = delta > 0 ? 1 : 0;
+    
+    // Ô viền không bao giờ đạt threshold, nên chỉ ô trong bàn mới phải đọc grid
+    for (int dr = -CANDIDATE_RADIUS; dr <= CANDIDATE_RADIUS; dr++) {
+        for (int dc = -CANDIDATE_RADIUS; dc <= CANDIDATE_RADIUS; dc++) {
+            if (dr == 0 && dc == 0) continue;
+            
+            std::uint8_t& count = center[dr * stride + dc];
+            count = static_cast<std::uint8_t>(count + delta);
+            if (count != threshold) continue;
+            
+            int r = row + dr, c = col + dc;
+            if (grid[static_cast<size_t>(r) * n + c] != EMPTY) continue;
+            
+            if (delta > 0) {
+                addCandidate(r, c);
+            } else {
+                removeCandidate(r, c);
+            }
+        }
+    }
+}
+
+void Board::resetNeighborCounts() {
+    const int stride = paddedStride();
+    neighborCounts.assign(static_cast<size_t>(stride) * stride, BORDER_COUNT);
+    for (int row = 0; row < size; row++) {
+        std::fill_n(neighborCounts.begin() + paddedIndex(row, 0), size, 0);
+    }
+}
+
+void Board::addCandidate(int row, int col) {
+    int& position = candidatePositions[index(row, col)];
+    if (position < 0) {
+        position = static_cast<int>(candidateCells.size());
+        candidateCells.emplace_back(row, col);
+    }
+}
+
+void Board::removeCandidate(int row, int col) {
+    int& position = candidatePositions[index(row, col)];
+    if (position < 0) {
+        return;
+    }
+    
+    // Swap-and-pop: đưa phần tử cuối vào chỗ trống
+    const std::pair<int, int> moved = candidateCells.back();
+    candidateCells[position] = moved;
+    candidatePositions[index(moved.first, moved.second)] = position;
+    candidateCells.pop_back();
+    position = -1;
+}
+
+void Board::rebuildCandidates() {
+    resetNeighborCounts();
+    candidatePositions.assign(static_cast<size_t>(size) * size, -1);
+    candidateCells.clear();
+    for (const auto& [row, col] : occupiedCells) {
+        updateNeighborCounts(row, col, +1);
+    }
+}
+
 #endif // BOARD_H
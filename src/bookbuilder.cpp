@@ -0,0 +1,143 @@
+// bookbuilder.cpp - Opening Book Builder
+// Người 1: Logic & AI - Build sách khai cuộc từ file record (vd. của caro_tournament) và/hoặc ván tự đánh
+//
+// Build: g++ -std=c++17 -O2 -pthread bookbuilder.cpp -o caro_book
+// Usage: caro_book --output FILE [--size S] [--max-ply N] [--min-weight W] [--records FILE]...
+//                  [--self-play N] [--difficulty D] [--random-plies N] [--seed S]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+#include "board.cpp"
+#include "gamelogic.cpp"
+#include "ai.cpp"
+#include "gamerecord.cpp"
+#include "openingbook.cpp"
+
+/**
+ * @class OpeningBookTool
+ * @brief Command-line driver for OpeningBookBuilder: record files and self-play in, one book file out
+ *
+ * - Mỗi --records thêm mọi ván cùng kích thước --size trong file (ván khác kích thước bị bỏ qua);
+ *   file của caro_tournament --records dùng được trực tiếp
+ * - --self-play N cho hai AI cùng difficulty tự đánh N ván, seed cố định nên build lại cho cùng sách
+ * - Sách ghi kích thước bàn vào header; AI chỉ dùng sách trên bàn cùng kích thước
+ */
+class OpeningBookTool {
+public:
+    struct Options {
+        std::string outputPath;
+        int boardSize;
+        int maxPly;
+        int minWeight;                      // Bỏ vị trí có trọng số nước tốt nhất thấp hơn
+        std::vector<std::string> recordPaths;
+        int selfPlayGames;
+        AI::Difficulty difficulty;
+        int randomPlies;                    // Nước ngẫu nhiên gần tâm đầu mỗi ván tự đánh
+        std::uint32_t seed;
+
+        Options() : boardSize(15), maxPly(OpeningBookBuilder::DEFAULT_MAX_PLY), minWeight(1), selfPlayGames(0),
+                    difficulty(AI::Difficulty::MEDIUM), randomPlies(2), seed(20240601u) {}
+    };
+
+    explicit OpeningBookTool(const Options& options) : options(options), builder(options.boardSize, options.maxPly) {}
+
+    /**
+     * @return false nếu không mở được file record hoặc không ghi được sách
+     */
+    bool run() {
+        for (const std::string& path : options.recordPaths) {
+            GameRecordReader reader;
+            if (!reader.open(path)) {
+                std::cerr << "Cannot open records " << path << std::endl;
+                return false;
+            }
+            size_t added = builder.addRecords(reader);
+            std::cerr << path << ": " << added << " games" << (reader.isCorrupt() ? " (stopped at corrupt game)" : "")
+                      << std::endl;
+        }
+
+        if (options.selfPlayGames > 0) {
+            AI first(1, options.difficulty), second(2, options.difficulty);
+            first.setSeed(options.seed);
+            second.setSeed(options.seed + 1);
+            builder.addSelfPlay(first, second, options.selfPlayGames, options.randomPlies, options.seed);
+            std::cerr << "self-play: " << options.selfPlayGames << " games" << std::endl;
+        }
+
+        if (!builder.save(options.outputPath, options.minWeight)) {
+            std::cerr << "Cannot write " << options.outputPath << std::endl;
+            return false;
+        }
+        std::cout << "book " << options.outputPath << ": size " << options.boardSize << ", max ply "
+                  << options.maxPly << ", " << builder.getPositionCount() << " positions from "
+                  << builder.getGamesAdded() << " games" << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief Đọc tham số dòng lệnh; false nếu tham số sai hoặc thiếu --output
+     */
+    static bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+
+            if (arg == "--output") {
+                options.outputPath = value;
+            } else if (arg == "--size") {
+                options.boardSize = std::atoi(value.c_str());
+                if (options.boardSize < Board::MIN_SIZE || options.boardSize > Board::MAX_SIZE) return false;
+            } else if (arg == "--max-ply") {
+                options.maxPly = std::atoi(value.c_str());
+                if (options.maxPly <= 0 || options.maxPly > 0xFFFF) return false;
+            } else if (arg == "--min-weight") {
+                options.minWeight = std::atoi(value.c_str());
+                if (options.minWeight <= 0) return false;
+            } else if (arg == "--records") {
+                options.recordPaths.push_back(value);
+            } else if (arg == "--self-play") {
+                options.selfPlayGames = std::atoi(value.c_str());
+                if (options.selfPlayGames < 0) return false;
+            } else if (arg == "--difficulty") {
+                switch (std::atoi(value.c_str())) {
+                    case 1: options.difficulty = AI::Difficulty::BEGINNER; break;
+                    case 2: options.difficulty = AI::Difficulty::EASY; break;
+                    case 4: options.difficulty = AI::Difficulty::MEDIUM; break;
+                    case 6: options.difficulty = AI::Difficulty::HARD; break;
+                    case 8: options.difficulty = AI::Difficulty::EXPERT; break;
+                    default: return false;
+                }
+            } else if (arg == "--random-plies") {
+                options.randomPlies = std::atoi(value.c_str());
+                if (options.randomPlies < 0) return false;
+            } else if (arg == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            } else {
+                return false;
+            }
+        }
+        return !options.outputPath.empty();
+    }
+
+private:
+    Options options;
+    OpeningBookBuilder builder;
+};
+
+int main(int argc, char** argv) {
+    OpeningBookTool::Options options;
+    if (!OpeningBookTool::parseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " --output FILE [--size S] [--max-ply N] [--min-weight W]"
+                  << " [--records FILE]... [--self-play N] [--difficulty 1|2|4|6|8] [--random-plies N] [--seed S]"
+                  << std::endl;
+        return 2;
+    }
+
+    OpeningBookTool tool(options);
+    return tool.run() ? 0 : 1;
+}
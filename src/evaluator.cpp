@@ -0,0 +1,264 @@
+// evaluator.cpp - Incremental Position Evaluator
+// Người 1: Logic & AI - Cache điểm theo từng đường, cập nhật sau mỗi make/unmake
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "board.cpp"
+#include "lineruns.cpp"
+#include "fixedsize.cpp"
+
+/**
+ * @class IncrementalEvaluator
+ * @brief Per-line pattern scores for both players, updated only along the lines through a changed cell
+ *
+ * Điểm của một người chơi = tổng trên mọi ô trống, mọi hướng, của RUN_SCORES[n]
+ * với n = số quân liên tiếp của người đó ở hai bên ô trống trên hướng đang xét
+ * (đúng công thức pointScore). Ô trống có n > 0 luôn có quân kề bên,
+ * nên điểm tách được thành tổng theo từng đường: một quân được đặt hay nhấc ra
+ * chỉ làm thay đổi 4 đường đi qua nó.
+ *
+ * - attach(): O(n²), gọi một lần khi bắt đầu search; độ dài chuỗi lấy từ LineRuns
+ *   (tính cả bàn bằng SIMD) thay vì quét từng đường
+ * - update(): O(4 * n) sau mỗi makeMove/undoLastMove; đi trên bản sao grid có viền WALL
+ *   nên mỗi đường chỉ là một vòng chạy tới sentinel, chấm cả hai người chơi trong
+ *   một lượt, và được sinh riêng cho 15x15 / 19x19 qua FixedSize::dispatch
+ * - getScore(): O(1)
+ *
+ * Hai thước đo phụ cho PlayStyle của AI được giữ cùng lúc để lá search không phải quét bàn:
+ * - getPatternScore(): tổng pointScore trên mọi quân của người chơi = tổng theo từng chuỗi
+ *   n quân của n * runScore(n), nên cũng tách theo đường và được chấm trong cùng lượt update();
+ *   chỉ giữ khi attach(board, true) vì làm update() chậm hơn, AI chỉ bật cho style cần nó
+ * - getCenterScore(): tổng centerWeight trên các quân, bảng trọng số theo ô tính sẵn trong attach(),
+ *   luôn giữ (hai phép cộng mỗi update())
+ */
+class IncrementalEvaluator {
+public:
+    static const int DIRECTION_COUNT = LineBitboards::DIRECTION_COUNT;
+
+    /**
+     * @brief Điểm theo độ dài chuỗi 0, 1, 2, 3, 4, >= 5
+     */
+    static int runScore(int count) noexcept {
+        static const int RUN_SCORES[6] = {0, 10, 100, 1000, 10000, 100000};
+        return RUN_SCORES[std::min(count, 5)];
+    }
+
+    /**
+     * @brief Tổng runScore trên 4 hướng của chuỗi qua (row, col), tính cả ô giữa nếu có quân
+     *
+     * Thước đo chung của engine: AI dùng cho điểm sắp xếp nước (ô trống) và điểm
+     * pattern theo style (ô có quân); tổng trên mọi ô trống chính là getScore().
+     */
+    static int pointScore(const Board& board, int row, int col, int player) noexcept {
+        const LineBitboards& masks = board.getLineMasks();
+        int score = 0;
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            score += runScore(masks.countInLine(row, col, d, player));
+        }
+        return score;
+    }
+
+    static const int CENTER_RADIUS = 3;
+
+    /**
+     * @brief Trọng số kiểm soát trung tâm: (4 - khoảng cách Manhattan tới tâm) * 10
+     *        trong ô vuông 7x7 quanh tâm, 0 ở ngoài
+     */
+    static int centerWeight(int size, int row, int col) noexcept {
+        int dr = std::abs(row - size / 2);
+        int dc = std::abs(col - size / 2);
+        if (dr > CENTER_RADIUS || dc > CENTER_RADIUS) return 0;
+        return (4 - dr - dc) * 10;
+    }
+
+    static constexpr BoardView::Cell WALL = 3;      // Viền quanh bản sao grid
+
+    IncrementalEvaluator() : size(0), patternsTracked(false), totals{0, 0}, patternTotals{0, 0}, centerTotals{0, 0} {}
+
+    /**
+     * @brief Tính lại toàn bộ cache cho board; trackPatterns = giữ cả getPatternScore()
+     */
+    void attach(const Board& board, bool trackPatterns = false) {
+        size = board.getSize();
+        patternsTracked = trackPatterns;
+        for (int p = 0; p < 2; p++) {
+            totals[p] = patternTotals[p] = centerTotals[p] = 0;
+        }
+
+        const BoardView grid = board.getGrid();
+        cells.assign(static_cast<size_t>(size + 2) * (size + 2), WALL);
+        centerWeights.assign(cells.size(), 0);
+        for (int row = 0; row < size; row++) {
+            std::copy_n(grid[row], size, cells.begin() + paddedIndex(row, 0));
+            for (int col = 0; col < size; col++) {
+                centerWeights[paddedIndex(row, col)] = centerWeight(size, row, col);
+            }
+        }
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            int lineCount = (d < LineBitboards::DIAGONAL) ? size : 2 * size - 1;
+            for (int p = 0; p < 2; p++) {
+                lineScores[p][d].assign(lineCount, 0);
+                linePatternScores[p][d].assign(trackPatterns ? lineCount : 0, 0);
+            }
+        }
+
+        for (int p = 0; p < 2; p++) {
+            runs.compute(grid, p + 1);
+            runs.forEachOpenRun([&](int d, int row, int col, int around) {
+                int score = runScore(around);
+                lineScores[p][d][lineIndex(d, row, col)] += score;
+                totals[p] += score;
+            });
+
+            for (const auto& [row, col] : board.getOccupiedCells()) {
+                if (grid[row][col] != p + 1) continue;
+                centerTotals[p] += centerWeights[paddedIndex(row, col)];
+                if (!trackPatterns) continue;
+                for (int d = 0; d < DIRECTION_COUNT; d++) {
+                    int score = runScore(runs.through(d, row, col));
+                    linePatternScores[p][d][lineIndex(d, row, col)] += score;
+                    patternTotals[p] += score;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Cập nhật sau khi ô (row, col) vừa được đặt quân hoặc nhấc quân
+     */
+    void update(const Board& board, int row, int col) {
+        size_t index = paddedIndex(row, col);
+        BoardView::Cell previous = cells[index];
+        BoardView::Cell current = static_cast<BoardView::Cell>(board.getCell(row, col));
+        if (previous != Board::EMPTY) centerTotals[previous - 1] -= centerWeights[index];
+        if (current != Board::EMPTY) centerTotals[current - 1] += centerWeights[index];
+        cells[index] = current;
+        FixedSize::dispatch(size, [&](auto fixed) {
+            if (patternsTracked) {
+                updateLines<decltype(fixed)::value, true>(row, col);
+            } else {
+                updateLines<decltype(fixed)::value, false>(row, col);
+            }
+        });
+    }
+
+    int getScore(int player) const noexcept { return totals[player - 1]; }
+    int getPatternScore(int player) const noexcept { return patternTotals[player - 1]; }     // 0 nếu không track
+    int getCenterScore(int player) const noexcept { return centerTotals[player - 1]; }
+
+private:
+    int size;
+    bool patternsTracked;
+    std::vector<int> lineScores[2][DIRECTION_COUNT];
+    std::vector<int> linePatternScores[2][DIRECTION_COUNT];
+    int totals[2];
+    int patternTotals[2];
+    int centerTotals[2];
+    std::vector<BoardView::Cell> cells;     // Grid (size + 2) x (size + 2), viền WALL
+    std::vector<int> centerWeights;         // centerWeight theo cùng bố cục với cells, 0 ở viền
+    LineRuns runs;                  // Scratch cho attach()
+
+    size_t paddedIndex(int row, int col) const noexcept {
+        return static_cast<size_t>(row + 1) * (size + 2) + col + 1;
+    }
+
+    // Cùng cách đánh số đường với LineBitboards
+    int lineIndex(int dir, int row, int col) const noexcept {
+        switch (dir) {
+            case LineBitboards::HORIZONTAL: return row;
+            case LineBitboards::VERTICAL: return col;
+            case LineBitboards::DIAGONAL: return row - col + size - 1;
+            default: return row + col;
+        }
+    }
+
+    /**
+     * @brief Chấm lại 4 đường qua (row, col); N là kích thước biết lúc compile hoặc GENERIC,
+     *        Patterns = chấm cả điểm pattern
+     */
+    template<int N, bool Patterns>
+    void updateLines(int row, int col) noexcept {
+        const int n = FixedSize::resolve<N>(size);
+        const std::ptrdiff_t stride = n + 2;
+        const BoardView::Cell* origin = cells.data() + stride + 1;     // Ô (0, 0)
+
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            // Ô đầu tiên trong bàn của đường và bước đi theo hướng d
+            int startRow, startCol;
+            std::ptrdiff_t step;
+            switch (d) {
+                case LineBitboards::HORIZONTAL:
+                    startRow = row; startCol = 0; step = 1;
+                    break;
+                case LineBitboards::VERTICAL:
+                    startRow = 0; startCol = col; step = stride;
+                    break;
+                case LineBitboards::DIAGONAL:
+                    startRow = std::max(0, row - col); startCol = startRow - (row - col); step = stride + 1;
+                    break;
+                default:
+                    startRow = std::max(0, row + col - (n - 1)); startCol = row + col - startRow; step = stride - 1;
+                    break;
+            }
+
+            int scores[2], patterns[2];
+            scoreLine<Patterns>(origin + startRow * stride + startCol, step, scores, patterns);
+
+            int line = lineIndex(d, row, col);
+            for (int p = 0; p < 2; p++) {
+                totals[p] += scores[p] - lineScores[p][d][line];
+                lineScores[p][d][line] = scores[p];
+                if constexpr (Patterns) {
+                    patternTotals[p] += patterns[p] - linePatternScores[p][d][line];
+                    linePatternScores[p][d][line] = patterns[p];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Điểm của cả hai người chơi trên một đường, đi từ cell tới ô WALL đầu tiên
+     *
+     * Mỗi ô trống cộng runScore(chuỗi ngay trước + chuỗi ngay sau). pending[p] là độ dài
+     * chuỗi của p ngay trước ô trống gần nhất (-1 nếu bị chặn), run[p] là chuỗi đang đếm;
+     * điểm của ô trống được cộng khi chuỗi sau nó kết thúc. patterns[p] cộng
+     * n * runScore(n) mỗi khi một chuỗi n quân của p kết thúc (chỉ khi Patterns).
+     */
+    template<bool Patterns>
+    static void scoreLine(const BoardView::Cell* cell, std::ptrdiff_t step, int scores[2], int patterns[2]) noexcept {
+        int run[2] = {0, 0};
+        int pending[2] = {-1, -1};
+        scores[0] = scores[1] = 0;
+        patterns[0] = patterns[1] = 0;
+
+        for (BoardView::Cell value = *cell; value != WALL; value = *(cell += step)) {
+            if (value == Board::EMPTY) {
+                for (int p = 0; p < 2; p++) {
+                    if (pending[p] >= 0) scores[p] += runScore(pending[p] + run[p]);
+                    if constexpr (Patterns) patterns[p] += run[p] * runScore(run[p]);
+                    pending[p] = run[p];
+                    run[p] = 0;
+                }
+            } else {
+                int own = value - 1;
+                int other = 1 - own;
+                run[own]++;
+                if (pending[other] >= 0) scores[other] += runScore(pending[other] + run[other]);
+                if constexpr (Patterns) patterns[other] += run[other] * runScore(run[other]);
+                pending[other] = -1;
+                run[other] = 0;
+            }
+        }
+
+        for (int p = 0; p < 2; p++) {
+            if (pending[p] >= 0) scores[p] += runScore(pending[p] + run[p]);
+            if constexpr (Patterns) patterns[p] += run[p] * runScore(run[p]);
+        }
+    }
+};
+
+#endif // EVALUATOR_H
@@ -0,0 +1,53 @@
+// fixedsize.cpp - Compile-Time Board Sizes
+// Người 1: Logic & AI - Chọn bản kernel sinh riêng cho 15x15 / 19x19, các cỡ khác dùng bản tổng quát
+#ifndef FIXEDSIZE_H
+#define FIXEDSIZE_H
+
+#include <type_traits>
+
+/**
+ * @class FixedSize
+ * @brief Runtime dispatcher from board size to kernels instantiated on a constexpr size
+ *
+ * Kernel là template theo int N: N = 15 hoặc 19 là kích thước biết lúc compile
+ * (stride, độ dài đường là hằng số, vòng 5x5 quanh một ô được unroll hết);
+ * N = GENERIC là bản dự phòng đọc kích thước lúc chạy, dùng cho mọi cỡ còn lại
+ * từ Board::MIN_SIZE đến Board::MAX_SIZE. Các kernel đi trên mảng có viền
+ * sentinel nên vòng trong không cần kiểm tra biên ở mọi bản.
+ *
+ * Thêm một cỡ chuyên biệt chỉ cần thêm một case trong dispatch().
+ *
+ *   FixedSize::dispatch(size, [&](auto fixed) {
+ *       kernel<decltype(fixed)::value>(...);
+ *   });
+ */
+class FixedSize {
+public:
+    static const int GENERIC = 0;
+
+    template<int N>
+    using Tag = std::integral_constant<int, N>;
+
+    /**
+     * @brief Kích thước dùng trong kernel N: hằng số N, hoặc runtimeSize với bản GENERIC
+     */
+    template<int N>
+    static constexpr int resolve(int runtimeSize) noexcept {
+        return N == GENERIC ? runtimeSize : N;
+    }
+
+    template<typename Kernel>
+    static decltype(auto) dispatch(int size, Kernel&& kernel) {
+        switch (size) {
+            case 15: return kernel(Tag<15>());
+            case 19: return kernel(Tag<19>());
+            default: return kernel(Tag<GENERIC>());
+        }
+    }
+
+    static bool isSpecialized(int size) noexcept {
+        return dispatch(size, [](auto fixed) { return decltype(fixed)::value != GENERIC; });
+    }
+};
+
+#endif // FIXEDSIZE_H
@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <array>
 
+#include "board.cpp"
+#include "patterntable.cpp"
+
 /**
  * @class GameLogic  
  * @brief Pure algorithm library for game rules validation
@@ -50,6 +53,9 @@ public:
         FOUR_SEMI,       // 4 quân mở 1 đầu
         FIVE             // 5 quân (thắng)
     };
+    static_assert(static_cast<int>(PatternType::FIVE) == PatternTable::FIVE &&
+                  static_cast<int>(PatternType::THREE_OPEN) == PatternTable::THREE_OPEN,
+                  "PatternType must match PatternTable::Code");
     
 private:
     // Search directions: horizontal, vertical, diagonal1, diagonal2  
@@ -66,7 +72,7 @@ public:
      * @param player Player making move (1 or 2)
      * @return MoveResult indicating validity
      */
-    static MoveResult validateMove(const std::vector<std::vector<int>>& board, 
+    static MoveResult validateMove(const BoardView& board, 
                                   int row, int col, int player);
     
     /**
@@ -76,9 +82,21 @@ public:
      * @param lastCol Last move column (-1 if no moves) 
      * @return GameState indicating current game status
      */
-    static GameState checkGameState(const std::vector<std::vector<int>>& board, 
+    static GameState checkGameState(const BoardView& board, 
                                    int lastRow = -1, int lastCol = -1);
     
+    /**
+     * @brief O(1) version: win via the line bitboards at the last move, draw via moveCount
+     * @param board Current board state (last move taken from board.getLastMove())
+     * @return GameState indicating current game status
+     */
+    static GameState checkGameState(const Board& board);
+    
+    /**
+     * @brief O(1) version for an explicit last move (-1 if no moves)
+     */
+    static GameState checkGameState(const Board& board, int lastRow, int lastCol);
+    
     /**
      * @brief Check if specific position results in win
      * @param board Board state
@@ -87,9 +105,14 @@ public:
      * @param player Player to check
      * @return true if position creates winning condition
      */
-    static bool checkWinAtPosition(const std::vector<std::vector<int>>& board,
+    static bool checkWinAtPosition(const BoardView& board,
                                   int row, int col, int player);
     
+    /**
+     * @brief Bitboard version: a handful of shift-AND operations per direction
+     */
+    static bool checkWinAtPosition(const Board& board, int row, int col, int player);
+    
     // === AI EVALUATION FUNCTIONS ===
     
     /**
@@ -100,7 +123,7 @@ public:
      * @param player Player to evaluate for
      * @return Score value (higher = better for player)
      */
-    static int evaluatePosition(const std::vector<std::vector<int>>& board,
+    static int evaluatePosition(const BoardView& board,
                                int row, int col, int player);
     
     /**
@@ -109,7 +132,7 @@ public:
      * @param player Player to evaluate
      * @return Overall board score for player
      */
-    static int evaluateBoard(const std::vector<std::vector<int>>& board, int player);
+    static int evaluateBoard(const BoardView& board, int player);
     
     /**
      * @brief Get pattern type at specific position and direction
@@ -120,8 +143,17 @@ public:
      * @param dy Direction y component  
      * @param player Player to check
      * @return PatternType found
+     *
+     * Ô (row, col) được coi là quân của player (ô trống = nước giả định).
+     * Tra bảng PatternTable trên cửa sổ 9 ô, nhận ra cả pattern gãy (X_XXX, XX_XX).
      */
-    static PatternType getPattern(const std::vector<std::vector<int>>& board,
+    static PatternType getPattern(const BoardView& board,
+                                 int row, int col, int dx, int dy, int player);
+    
+    /**
+     * @brief Bitboard version: window masks come straight from the line bitboards
+     */
+    static PatternType getPattern(const Board& board,
                                  int row, int col, int dx, int dy, int player);
     
     // === THREAT DETECTION ===
@@ -134,9 +166,14 @@ public:
      * @param player Player to check
      * @return true if creates winning threat
      */
-    static bool isWinningThreat(const std::vector<std::vector<int>>& board,
+    static bool isWinningThreat(const BoardView& board,
                                int row, int col, int player);
     
+    /**
+     * @brief Bitboard version: probes the hypothetical stone inside the line masks
+     */
+    static bool isWinningThreat(const Board& board, int row, int col, int player);
+    
     /**
      * @brief Check if position blocks opponent's winning threat
      * @param board Board state
@@ -145,16 +182,18 @@ public:
      * @param player Player making defensive move
      * @return true if blocks opponent threat
      */
-    static bool isBlockingThreat(const std::vector<std::vector<int>>& board,
+    static bool isBlockingThreat(const BoardView& board,
                                 int row, int col, int player);
     
+    static bool isBlockingThreat(const Board& board, int row, int col, int player);
+    
     /**
      * @brief Find all immediate threats on board
      * @param board Board state
      * @param player Player to find threats for
      * @return Vector of threat positions
      */
-    static std::vector<std::pair<int, int>> findThreats(const std::vector<std::vector<int>>& board,
+    static std::vector<std::pair<int, int>> findThreats(const BoardView& board,
                                                         int player);
     
     // === UTILITY FUNCTIONS ===
@@ -169,7 +208,7 @@ public:
      * @param player Player to count
      * @return Number of consecutive pieces
      */
-    static int countConsecutive(const std::vector<std::vector<int>>& board,
+    static int countConsecutive(const BoardView& board,
                                int row, int col, int dx, int dy, int player);
     
     /**
@@ -182,9 +221,14 @@ public:
      * @param player Player to count
      * @return Total pieces in line including center
      */
-    static int countInLine(const std::vector<std::vector<int>>& board,
+    static int countInLine(const BoardView& board,
                           int row, int col, int dx, int dy, int player);
     
+    /**
+     * @brief Bitboard version of countInLine (no per-cell walk)
+     */
+    static int countInLine(const Board& board, int row, int col, int dx, int dy, int player);
+    
     /**
      * @brief Convert GameState to string for logging/display
      */
@@ -202,10 +246,8 @@ public:
 
 private:
     // === INTERNAL HELPERS ===
-    static bool isValidPosition(const std::vector<std::vector<int>>& board, int row, int col);
-    static int countOpenEnds(const std::vector<std::vector<int>>& board,
-                            int row, int col, int dx, int dy, int consecutiveCount, int player);
-    static PatternType classifyPattern(int consecutiveCount, int openEnds);
+    static bool isValidPosition(const BoardView& board, int row, int col);
+    static bool makesFive(const BoardView& board, int row, int col, int player);
 };
 
 // === STATIC MEMBER DEFINITIONS ===
@@ -219,7 +261,7 @@ const std::array<std::pair<int, int>, 4> GameLogic::DIRECTIONS = {{
 
 // === IMPLEMENTATION ===
 
-GameLogic::MoveResult GameLogic::validateMove(const std::vector<std::vector<int>>& board,
+GameLogic::MoveResult GameLogic::validateMove(const BoardView& board,
                                              int row, int col, int player) {
     // Check player validity
     if (player != 1 && player != 2) {
@@ -239,7 +281,7 @@ GameLogic::MoveResult GameLogic::validateMove(const std::vector<std::vector<int>
     return MoveResult::VALID;
 }
 
-GameLogic::GameState GameLogic::checkGameState(const std::vector<std::vector<int>>& board,
+GameLogic::GameState GameLogic::checkGameState(const BoardView& board,
                                               int lastRow, int lastCol) {
     // Check for win if last move is provided
     if (lastRow >= 0 && lastCol >= 0 && isValidPosition(board, lastRow, lastCol)) {
@@ -250,25 +292,38 @@ GameLogic::GameState GameLogic::checkGameState(const std::vector<std::vector<int
     }
     
     // Check for draw (board full)
-    bool boardFull = true;
-    for (const auto& row : board) {
-        for (int cell : row) {
-            if (cell == 0) {
-                boardFull = false;
-                break;
-            }
-        }
-        if (!boardFull) break;
+    const int cellCount = board.getSize() * board.getSize();
+    const BoardView::Cell* cells = board.data();
+    
+    if (std::find(cells, cells + cellCount, 0) == cells + cellCount) {
+        return GameState::DRAW;
     }
     
-    if (boardFull) {
+    return GameState::PLAYING;
+}
+
+GameLogic::GameState GameLogic::checkGameState(const Board& board) {
+    auto [lastRow, lastCol, lastPlayer] = board.getLastMove();
+    (void)lastPlayer;
+    return checkGameState(board, lastRow, lastCol);
+}
+
+GameLogic::GameState GameLogic::checkGameState(const Board& board, int lastRow, int lastCol) {
+    // Thắng chỉ có thể đi qua nước cuối: vài phép shift-AND trên bitboard của 4 hướng
+    int lastPlayer = board.getCell(lastRow, lastCol);
+    if (lastPlayer > 0 && board.hasFiveAt(lastRow, lastCol, lastPlayer)) {
+        return (lastPlayer == 1) ? GameState::PLAYER1_WIN : GameState::PLAYER2_WIN;
+    }
+    
+    // Hòa: Board đếm số quân nên không cần quét tìm ô trống
+    if (board.isFull()) {
         return GameState::DRAW;
     }
     
     return GameState::PLAYING;
 }
 
-bool GameLogic::checkWinAtPosition(const std::vector<std::vector<int>>& board,
+bool GameLogic::checkWinAtPosition(const BoardView& board,
                                   int row, int col, int player) {
     if (!isValidPosition(board, row, col) || board[row][col] != player) {
         return false;
@@ -285,7 +340,11 @@ bool GameLogic::checkWinAtPosition(const std::vector<std::vector<int>>& board,
     return false;
 }
 
-int GameLogic::evaluatePosition(const std::vector<std::vector<int>>& board,
+bool GameLogic::checkWinAtPosition(const Board& board, int row, int col, int player) {
+    return board.hasFiveAt(row, col, player);
+}
+
+int GameLogic::evaluatePosition(const BoardView& board,
                                int row, int col, int player) {
     if (!isValidPosition(board, row, col)) {
         return 0;
@@ -302,15 +361,54 @@ int GameLogic::evaluatePosition(const std::vector<std::vector<int>>& board,
     return totalScore;
 }
 
-int GameLogic::evaluateBoard(const std::vector<std::vector<int>>& board, int player) {
+int GameLogic::evaluateBoard(const BoardView& board, int player) {
     int totalScore = 0;
-    int size = board.size();
+    int size = board.getSize();
+    int opponent = (player == 1) ? 2 : 1;
+    const int radius = PatternTable::WINDOW_RADIUS;
+    const std::uint32_t newest = 1u << (PatternTable::WINDOW_SIZE - 1);
+    const std::uint32_t center = 1u << radius;
     
-    // Evaluate all positions where player could potentially play
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            if (board[i][j] == 0) {
-                totalScore += evaluatePosition(board, i, j, player);
+    // Evaluate all positions where player could potentially play.
+    // Trượt cửa sổ 9 ô dọc từng đường nên mỗi ô chỉ được đọc một lần cho mỗi hướng
+    // (cùng kết quả với gọi evaluatePosition cho từng ô trống).
+    for (const auto& [dx, dy] : DIRECTIONS) {
+        int lineCount = (dx == 0 || dy == 0) ? size : 2 * size - 1;
+        for (int line = 0; line < lineCount; line++) {
+            // Ô đầu và độ dài của đường
+            int row, col, length;
+            if (dx == 0) {
+                row = line; col = 0; length = size;
+            } else if (dy == 0) {
+                row = 0; col = line; length = size;
+            } else if (line < size) {
+                row = 0; col = line;
+                length = (dy > 0) ? size - line : line + 1;
+            } else {
+                row = line - size + 1;
+                col = (dy > 0) ? 0 : size - 1;
+                length = size - row;
+            }
+            
+            // Ngoài bàn cờ tính là bị chặn
+            std::uint32_t own = 0;
+            std::uint32_t blocked = (1u << PatternTable::WINDOW_SIZE) - 1;
+            for (int step = 0; step < length + radius; step++) {
+                own >>= 1;
+                blocked >>= 1;
+                
+                if (step < length) {
+                    int cell = board[row + step * dx][col + step * dy];
+                    if (cell == player) own |= newest;
+                    else if (cell == opponent) blocked |= newest;
+                } else {
+                    blocked |= newest;
+                }
+                
+                // Ô giữa cửa sổ (cách ô vừa đọc radius bước) còn trống thì tính điểm
+                if (step >= radius && !((own | blocked) & center)) {
+                    totalScore += getPatternScore(static_cast<PatternType>(PatternTable::lookup(own, blocked)));
+                }
             }
         }
     }
@@ -318,31 +416,72 @@ int GameLogic::evaluateBoard(const std::vector<std::vector<int>>& board, int pla
     return totalScore;
 }
 
-GameLogic::PatternType GameLogic::getPattern(const std::vector<std::vector<int>>& board,
+GameLogic::PatternType GameLogic::getPattern(const BoardView& board,
                                            int row, int col, int dx, int dy, int player) {
-    // Count consecutive pieces in line
-    int consecutiveCount = countInLine(board, row, col, dx, dy, player);
+    // Mã hóa cửa sổ 9 ô: own = quân player, blocked = quân đối thủ hoặc ngoài bàn cờ
+    const int radius = PatternTable::WINDOW_RADIUS;
+    std::uint32_t own = 0;
+    std::uint32_t blocked = 0;
+    
+    if (isValidPosition(board, row - radius * dx, col - radius * dy) &&
+        isValidPosition(board, row + radius * dx, col + radius * dy)) {
+        // Cả cửa sổ nằm trong bàn cờ: đọc thẳng theo stride, không kiểm tra biên từng ô
+        const BoardView::Cell* cell = board[row - radius * dx] + (col - radius * dy);
+        const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(dx) * board.getSize() + dy;
+        const int opponent = (player == 1) ? 2 : 1;
+        for (int k = 0; k < PatternTable::WINDOW_SIZE; k++, cell += stride) {
+            own |= static_cast<std::uint32_t>(*cell == player) << k;
+            blocked |= static_cast<std::uint32_t>(*cell == opponent) << k;
+        }
+    } else {
+        for (int k = -radius; k <= radius; k++) {
+            int r = row + k * dx;
+            int c = col + k * dy;
+            std::uint32_t bit = 1u << (k + radius);
+            
+            if (!isValidPosition(board, r, c)) {
+                blocked |= bit;
+            } else if (board[r][c] == player) {
+                own |= bit;
+            } else if (board[r][c] != 0) {
+                blocked |= bit;
+            }
+        }
+    }
     
-    // Count open ends
-    int openEnds = countOpenEnds(board, row, col, dx, dy, consecutiveCount, player);
+    return static_cast<PatternType>(PatternTable::lookup(own, blocked));
+}
+
+GameLogic::PatternType GameLogic::getPattern(const Board& board,
+                                           int row, int col, int dx, int dy, int player) {
+    int dir = LineBitboards::directionIndex(dx, dy);
+    if (!board.isInBounds(row, col) || dir < 0) {
+        return PatternType::NONE;
+    }
     
-    return classifyPattern(consecutiveCount, openEnds);
+    const LineBitboards& masks = board.getLineMasks();
+    int opponent = (player == 1) ? 2 : 1;
+    std::uint32_t own = masks.window(row, col, dir, player);
+    std::uint32_t blocked = masks.window(row, col, dir, opponent) | (~masks.boardWindow(row, col, dir) & 0x1FF);
+    
+    // directionIndex gộp hướng ngược chiều; pattern đối xứng nên không cần lật mask
+    return static_cast<PatternType>(PatternTable::lookup(own, blocked));
 }
 
-bool GameLogic::isWinningThreat(const std::vector<std::vector<int>>& board,
+bool GameLogic::isWinningThreat(const BoardView& board,
                                int row, int col, int player) {
     if (!isValidPosition(board, row, col) || board[row][col] != 0) {
         return false;
     }
     
-    // Simulate placing the piece
-    std::vector<std::vector<int>> tempBoard = board;
-    tempBoard[row][col] = player;
-    
-    return checkWinAtPosition(tempBoard, row, col, player);
+    return makesFive(board, row, col, player);
+}
+
+bool GameLogic::isWinningThreat(const Board& board, int row, int col, int player) {
+    return board.makesFive(row, col, player);
 }
 
-bool GameLogic::isBlockingThreat(const std::vector<std::vector<int>>& board,
+bool GameLogic::isBlockingThreat(const BoardView& board,
                                 int row, int col, int player) {
     if (!isValidPosition(board, row, col) || board[row][col] != 0) {
         return false;
@@ -351,16 +490,18 @@ bool GameLogic::isBlockingThreat(const std::vector<std::vector<int>>& board,
     int opponent = (player == 1) ? 2 : 1;
     
     // Check if opponent would win by playing here
-    std::vector<std::vector<int>> tempBoard = board;
-    tempBoard[row][col] = opponent;
-    
-    return checkWinAtPosition(tempBoard, row, col, opponent);
+    return makesFive(board, row, col, opponent);
+}
+
+bool GameLogic::isBlockingThreat(const Board& board, int row, int col, int player) {
+    int opponent = (player == 1) ? 2 : 1;
+    return board.makesFive(row, col, opponent);
 }
 
-std::vector<std::pair<int, int>> GameLogic::findThreats(const std::vector<std::vector<int>>& board,
+std::vector<std::pair<int, int>> GameLogic::findThreats(const BoardView& board,
                                                         int player) {
     std::vector<std::pair<int, int>> threats;
-    int size = board.size();
+    int size = board.getSize();
     
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
@@ -375,10 +516,9 @@ std::vector<std::pair<int, int>> GameLogic::findThreats(const std::vector<std::v
     return threats;
 }
 
-int GameLogic::countConsecutive(const std::vector<std::vector<int>>& board,
+int GameLogic::countConsecutive(const BoardView& board,
                                int row, int col, int dx, int dy, int player) {
     int count = 0;
-    int size = board.size();
     
     while (isValidPosition(board, row, col) && board[row][col] == player) {
         count++;
@@ -389,7 +529,7 @@ int GameLogic::countConsecutive(const std::vector<std::vector<int>>& board,
     return count;
 }
 
-int GameLogic::countInLine(const std::vector<std::vector<int>>& board,
+int GameLogic::countInLine(const BoardView& board,
                           int row, int col, int dx, int dy, int player) {
     // Count in positive direction (not including center)
     int positiveCount = countConsecutive(board, row + dx, col + dy, dx, dy, player);
@@ -403,6 +543,14 @@ int GameLogic::countInLine(const std::vector<std::vector<int>>& board,
     return positiveCount + negativeCount + centerCount;
 }
 
+int GameLogic::countInLine(const Board& board, int row, int col, int dx, int dy, int player) {
+    int dir = LineBitboards::directionIndex(dx, dy);
+    if (!board.isInBounds(row, col) || dir < 0) {
+        return 0;
+    }
+    return board.getLineMasks().countInLine(row, col, dir, player);
+}
+
 std::string GameLogic::gameStateToString(GameState state) {
     switch (state) {
         case GameState::PLAYING: return "PLAYING";
@@ -443,72 +591,22 @@ int GameLogic::getPatternScore(PatternType pattern) {
 
 // === PRIVATE HELPER IMPLEMENTATIONS ===
 
-bool GameLogic::isValidPosition(const std::vector<std::vector<int>>& board, int row, int col) {
-    int size = board.size();
+bool GameLogic::isValidPosition(const BoardView& board, int row, int col) {
+    int size = board.getSize();
     return row >= 0 && row < size && col >= 0 && col < size;
 }
 
-int GameLogic::countOpenEnds(const std::vector<std::vector<int>>& board,
-                            int row, int col, int dx, int dy, int consecutiveCount, int player) {
-    int openEnds = 0;
-    
-    // Check positive direction end
-    int posRow = row + dx * (consecutiveCount / 2 + 1);
-    int posCol = col + dy * (consecutiveCount / 2 + 1);
-    
-    // Walk to actual end of consecutive sequence
-    while (isValidPosition(board, posRow - dx, posCol - dy) && 
-           board[posRow - dx][posCol - dy] == player) {
-        posRow += dx;
-        posCol += dy;
-    }
-    
-    if (isValidPosition(board, posRow, posCol) && board[posRow][posCol] == 0) {
-        openEnds++;
-    }
-    
-    // Check negative direction end  
-    int negRow = row - dx * (consecutiveCount / 2 + 1);
-    int negCol = col - dy * (consecutiveCount / 2 + 1);
-    
-    // Walk to actual end of consecutive sequence
-    while (isValidPosition(board, negRow + dx, negCol + dy) && 
-           board[negRow + dx][negCol + dy] == player) {
-        negRow -= dx;
-        negCol -= dy;
-    }
-    
-    if (isValidPosition(board, negRow, negCol) && board[negRow][negCol] == 0) {
-        openEnds++;
-    }
-    
-    return openEnds;
-}
-
-GameLogic::PatternType GameLogic::classifyPattern(int consecutiveCount, int openEnds) {
-    if (consecutiveCount >= 5) {
-        return PatternType::FIVE;
-    }
-    
-    if (consecutiveCount == 4) {
-        if (openEnds >= 2) return PatternType::FOUR_OPEN;
-        if (openEnds == 1) return PatternType::FOUR_SEMI;
-    }
-    
-    if (consecutiveCount == 3) {
-        if (openEnds >= 2) return PatternType::THREE_OPEN;
-        if (openEnds == 1) return PatternType::THREE_SEMI;
-    }
-    
-    if (consecutiveCount == 2) {
-        return PatternType::PAIR;
-    }
-    
-    if (consecutiveCount == 1) {
-        return PatternType::SINGLE;
+bool GameLogic::makesFive(const BoardView& board, int row, int col, int player) {
+    // Probe the hypothetical stone in place: the empty center joins both runs
+    for (const auto& [dx, dy] : DIRECTIONS) {
+        int total = 1 + countConsecutive(board, row + dx, col + dy, dx, dy, player)
+                      + countConsecutive(board, row - dx, col - dy, -dx, -dy, player);
+        if (total >= WIN_LENGTH) {
+            return true;
+        }
     }
     
-    return PatternType::NONE;
+    return false;
 }
 
 #endif // GAMELOGIC_H
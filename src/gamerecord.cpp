@@ -0,0 +1,359 @@
+// gamerecord.cpp - Binary Game Records
+// Người 1: Logic & AI - Lưu ván cờ dạng nhị phân gọn và đọc lại bằng memory-mapped file
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GAMERECORD_HAS_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "board.cpp"
+#include "gamelogic.cpp"
+
+/**
+ * @brief Định dạng file (mọi số nguyên đều little-endian)
+ *
+ * File header, 8 byte: "CARO", version (1 byte), 3 byte dự trữ (0)
+ * Mỗi ván, 6 + 2 * moveCount byte, nối tiếp nhau:
+ * - boardSize (1), result (1, GameLogic::GameState), flags (1), dự trữ (1)
+ * - moveCount (2)
+ * - moveCount chỉ số ô row * boardSize + col (2 byte mỗi nước)
+ * Người đi được suy ra theo lượt: nước chẵn là người đi trước (flags bit 0: 0 = người 1,
+ * 1 = người 2), nước lẻ là người còn lại. Ván trung bình 40 nước chiếm 86 byte
+ * thay vì 480 byte của moveHistory.
+ */
+namespace GameRecord {
+    static const char MAGIC[4] = {'C', 'A', 'R', 'O'};
+    static const std::uint8_t VERSION = 1;
+    static const size_t FILE_HEADER_SIZE = 8;
+    static const size_t GAME_HEADER_SIZE = 6;
+    static const std::uint8_t FLAG_SECOND_PLAYER_FIRST = 0x01;
+    static const int MAX_MOVES = 0xFFFF;
+
+    inline std::uint16_t readU16(const std::uint8_t* bytes) noexcept {
+        return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    inline void appendU16(std::vector<std::uint8_t>& out, std::uint32_t value) {
+        out.push_back(static_cast<std::uint8_t>(value & 0xFF));
+        out.push_back(static_cast<std::uint8_t>((value >> 8) & 0xFF));
+    }
+}
+
+/**
+ * @class MappedFile
+ * @brief Read-only file contents, memory-mapped where the platform supports it
+ *
+ * Không có mmap (hoặc mmap lỗi) thì đọc cả file vào bộ nhớ; người dùng chỉ thấy data()/size().
+ */
+class MappedFile {
+public:
+    enum class Access {
+        SEQUENTIAL,                         // Duyệt từ đầu tới cuối (game records)
+        RANDOM                              // Tra ngẫu nhiên (opening book)
+    };
+
+    MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, Access access = Access::SEQUENTIAL) {
+        close();
+#if defined(GAMERECORD_HAS_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                madvise(address, static_cast<size_t>(info.st_size),
+                        access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+                bytes = static_cast<const std::uint8_t*>(address);
+                length = static_cast<size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped) return true;
+#else
+        (void)access;
+#endif
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (fallback.empty()) return false;
+        bytes = fallback.data();
+        length = fallback.size();
+        return true;
+    }
+
+    void close() {
+#if defined(GAMERECORD_HAS_MMAP)
+        if (mapped && bytes) {
+            munmap(const_cast<std::uint8_t*>(bytes), length);
+        }
+#endif
+        fallback.clear();
+        fallback.shrink_to_fit();
+        bytes = nullptr;
+        length = 0;
+        mapped = false;
+    }
+
+    const std::uint8_t* data() const noexcept { return bytes; }
+    size_t size() const noexcept { return length; }
+    bool isOpen() const noexcept { return bytes != nullptr; }
+    bool isMemoryMapped() const noexcept { return mapped; }
+
+private:
+    const std::uint8_t* bytes;
+    size_t length;
+    bool mapped;
+    std::vector<std::uint8_t> fallback;     // Dữ liệu file khi không mmap được
+};
+
+/**
+ * @class GameRecordWriter
+ * @brief Appends games to a record file; each game is encoded into a reused buffer and written in one call
+ *
+ * Ghi qua std::ofstream (buffer của stream); dữ liệu chắc chắn xuống file sau close().
+ */
+class GameRecordWriter {
+public:
+    GameRecordWriter() : gamesWritten(0) {}
+    ~GameRecordWriter() { close(); }
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    /**
+     * @brief Tạo file mới (ghi đè nếu đã có)
+     */
+    bool open(const std::string& path) {
+        close();
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        file.write(GameRecord::MAGIC, sizeof(GameRecord::MAGIC));
+        const char header[4] = {static_cast<char>(GameRecord::VERSION), 0, 0, 0};
+        file.write(header, sizeof(header));
+        gamesWritten = 0;
+        return static_cast<bool>(file);
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    bool write(const Board& board, GameLogic::GameState result) {
+        return write(board.getSize(), board.getMoveHistory(), result);
+    }
+
+    /**
+     * @return false nếu file chưa mở, lỗi ghi, hoặc lịch sử không hợp lệ
+     * (ô ngoài bàn, người đi không xen kẽ, quá MAX_MOVES nước)
+     */
+    bool write(int boardSize, const std::vector<std::tuple<int, int, int>>& moves, GameLogic::GameState result) {
+        if (!file.is_open() || boardSize < Board::MIN_SIZE || boardSize > Board::MAX_SIZE ||
+            moves.size() > static_cast<size_t>(GameRecord::MAX_MOVES)) {
+            return false;
+        }
+
+        int firstPlayer = moves.empty() ? 1 : std::get<2>(moves.front());
+        buffer.clear();
+        buffer.push_back(static_cast<std::uint8_t>(boardSize));
+        buffer.push_back(static_cast<std::uint8_t>(result));
+        buffer.push_back(firstPlayer == 2 ? GameRecord::FLAG_SECOND_PLAYER_FIRST : 0);
+        buffer.push_back(0);
+        GameRecord::appendU16(buffer, static_cast<std::uint32_t>(moves.size()));
+
+        for (size_t i = 0; i < moves.size(); i++) {
+            auto [row, col, player] = moves[i];
+            int expected = (i % 2 == 0) ? firstPlayer : 3 - firstPlayer;
+            if (player != expected || row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+                return false;
+            }
+            GameRecord::appendU16(buffer, static_cast<std::uint32_t>(row * boardSize + col));
+        }
+
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) return false;
+        gamesWritten++;
+        return true;
+    }
+
+    void close() {
+        if (file.is_open()) file.close();
+    }
+
+    size_t getGamesWritten() const noexcept { return gamesWritten; }
+
+private:
+    std::ofstream file;
+    std::vector<std::uint8_t> buffer;       // Tái sử dụng giữa các ván
+    size_t gamesWritten;
+};
+
+/**
+ * @class GameRecordReader
+ * @brief Read-only, memory-mapped view of a record file; games are decoded in place
+ *
+ * File được mmap một lần (hoặc đọc hết vào bộ nhớ nếu hệ thống không có mmap).
+ * next() chỉ kiểm tra header và nhảy qua 2 * moveCount byte nên duyệt hàng triệu ván
+ * gần như không tốn chi phí parse; nước đi chỉ được giải mã khi gọi getMove()/replay().
+ */
+class GameRecordReader {
+public:
+    /**
+     * @brief Một ván trong file; chỉ hợp lệ khi reader còn mở
+     */
+    class Game {
+    public:
+        Game() : bytes(nullptr) {}
+
+        int getBoardSize() const noexcept { return bytes[0]; }
+        GameLogic::GameState getResult() const noexcept { return static_cast<GameLogic::GameState>(bytes[1]); }
+        int getFirstPlayer() const noexcept { return (bytes[2] & GameRecord::FLAG_SECOND_PLAYER_FIRST) ? 2 : 1; }
+        int getMoveCount() const noexcept { return GameRecord::readU16(bytes + 4); }
+
+        /**
+         * @return (row, col, player) của nước thứ index
+         */
+        std::tuple<int, int, int> getMove(int index) const noexcept {
+            int cell = GameRecord::readU16(bytes + GameRecord::GAME_HEADER_SIZE + 2 * index);
+            int player = (index % 2 == 0) ? getFirstPlayer() : 3 - getFirstPlayer();
+            return std::make_tuple(cell / getBoardSize(), cell % getBoardSize(), player);
+        }
+
+        /**
+         * @brief Đặt lại board theo kích thước ván rồi đi moveLimit nước đầu (-1 = cả ván)
+         * @return false nếu có nước không hợp lệ (file hỏng)
+         */
+        bool replay(Board& board, int moveLimit = -1) const {
+            if (board.getSize() != getBoardSize()) {
+                board.reset(getBoardSize());
+                if (board.getSize() != getBoardSize()) return false;
+            } else {
+                board.reset();
+            }
+
+            int count = (moveLimit < 0) ? getMoveCount() : std::min(moveLimit, getMoveCount());
+            for (int i = 0; i < count; i++) {
+                auto [row, col, player] = getMove(i);
+                if (!board.makeMove(row, col, player)) return false;
+            }
+            return true;
+        }
+
+    private:
+        friend class GameRecordReader;
+        explicit Game(const std::uint8_t* data) : bytes(data) {}
+
+        const std::uint8_t* bytes;
+    };
+
+    GameRecordReader() : data(nullptr), length(0), offset(0), corrupt(false) {}
+
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        if (!file.open(path, MappedFile::Access::SEQUENTIAL)) return false;
+        data = file.data();
+        length = file.size();
+
+        if (length < GameRecord::FILE_HEADER_SIZE ||
+            std::memcmp(data, GameRecord::MAGIC, sizeof(GameRecord::MAGIC)) != 0 ||
+            data[4] != GameRecord::VERSION) {
+            close();
+            return false;
+        }
+
+        rewind();
+        return true;
+    }
+
+    void close() {
+        file.close();
+        data = nullptr;
+        length = 0;
+        offset = 0;
+        corrupt = false;
+    }
+
+    bool isOpen() const noexcept { return data != nullptr; }
+    bool isCorrupt() const noexcept { return corrupt; }
+    bool isMemoryMapped() const noexcept { return file.isMemoryMapped(); }
+    size_t getFileSize() const noexcept { return length; }
+
+    void rewind() noexcept {
+        offset = GameRecord::FILE_HEADER_SIZE;
+        corrupt = false;
+    }
+
+    /**
+     * @brief Ván kế tiếp; false khi hết file hoặc gặp ván hỏng (isCorrupt() = true):
+     *        header bị cắt cụt, kích thước bàn hay kết quả ngoài phạm vi, thiếu byte nước đi
+     */
+    bool next(Game& game) noexcept {
+        if (!data || offset >= length) return false;
+
+        if (length - offset < GameRecord::GAME_HEADER_SIZE) {
+            corrupt = true;
+            return false;
+        }
+
+        const std::uint8_t* bytes = data + offset;
+        size_t recordSize = GameRecord::GAME_HEADER_SIZE + 2 * static_cast<size_t>(GameRecord::readU16(bytes + 4));
+        if (bytes[0] < Board::MIN_SIZE || bytes[0] > Board::MAX_SIZE || length - offset < recordSize ||
+            bytes[1] > static_cast<std::uint8_t>(GameLogic::GameState::DRAW)) {
+            corrupt = true;
+            return false;
+        }
+
+        game = Game(bytes);
+        offset += recordSize;
+        return true;
+    }
+
+    /**
+     * @brief Gọi visit(game) cho mọi ván từ đầu file
+     * @return Số ván đã duyệt
+     */
+    template <typename Visit>
+    size_t forEach(Visit&& visit) {
+        rewind();
+        size_t count = 0;
+        Game game;
+        while (next(game)) {
+            visit(game);
+            count++;
+        }
+        return count;
+    }
+
+private:
+    MappedFile file;
+    const std::uint8_t* data;
+    size_t length;
+    size_t offset;                          // Vị trí ván kế tiếp
+    bool corrupt;
+};
+
+#endif // GAMERECORD_H
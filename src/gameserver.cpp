@@ -0,0 +1,653 @@
+// gameserver.cpp - Headless Multi-Game Engine Server
+// Người 1: Logic & AI - Nhiều ván song song trên một nhóm worker cố định, giao thức dòng lệnh qua stdin/stdout
+//
+// Build: g++ -std=c++17 -O2 -pthread gameserver.cpp -o caro_server
+// Usage: caro_server [--workers N] [--move-ms MS] [--hash-mb MB] [--hash shared|worker]
+//                    [--style balanced|aggressive|defensive|positional] [--book FILE]
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+#include "board.cpp"
+#include "gamelogic.cpp"
+#include "ai.cpp"
+
+/**
+ * @class GameServer
+ * @brief Many concurrent game sessions served by a fixed pool of search workers
+ *
+ * Giao thức: mỗi lệnh một dòng, mỗi phản hồi một dòng (phản hồi của search đến bất
+ * đồng bộ, không theo thứ tự lệnh; client phân biệt bằng id ván).
+ *
+ *   new <id> [size=15] [difficulty=4] [ai=2]   -> ok new <id>        (ai=1: AI đi trước ngay)
+ *   play <id> <row> <col> [moveMs]             -> move <id> <row> <col> <state> <queueMs> <searchMs> <nodes>
+ *                                                 hoặc end <id> <state> nếu nước của người chơi kết thúc ván
+ *   state <id>                                 -> state <id> <state> <moveCount> <busy 0|1>
+ *   stop <id>                                  -> ok stop <id>, rồi move ... với nước tốt nhất tìm được tới lúc đó
+ *   close <id>                                 -> ok close <id>  (search đang chạy của ván bị hủy)
+ *   stats                                      -> stats key=value ...
+ *   quit                                       -> chờ các search đang xếp hàng xong rồi thoát
+ *   lỗi                                        -> error <id|-> <lý do>
+ *
+ * - Session chỉ giữ kích thước, cấu hình và danh sách nước (2 byte mỗi nước); worker
+ *   đi lại lịch sử vào Board nháp của mình cho mỗi lần search, như BatchAnalyzer
+ * - Mỗi ván có tối đa một việc đang chờ, hàng đợi FIFO: các ván lần lượt được phục vụ
+ *   xoay vòng, không ván nào chiếm worker nhiều lần liên tiếp khi ván khác đang chờ
+ * - Deadline mỗi nước tính từ lúc nhận lệnh, nên thời gian xếp hàng trừ vào thời gian
+ *   nghĩ và độ trễ phản hồi bị chặn bởi moveMs (moveMs = 0: search theo depth của difficulty)
+ * - Transposition table dùng chung cho mọi worker (mặc định) hoặc chia đều cho từng worker;
+ *   hai AI của một worker luôn dùng chung table của worker đó
+ * - Không ponder: worker dùng chung cho mọi ván, nghĩ trước cho một ván đang chờ người
+ *   chơi sẽ chiếm chỗ của ván khác đang có việc thật
+ */
+class GameServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        int workerCount;                        // 0 = std::thread::hardware_concurrency()
+        std::chrono::milliseconds moveTime;     // Deadline mặc định mỗi nước, tính cả thời gian chờ
+        size_t hashMegabytes;                   // Tổng dung lượng table (chia đều nếu không dùng chung)
+        bool sharedHash;
+        AI::PlayStyle playStyle;                // Chung cho mọi ván để table dùng chung vẫn đúng
+        std::string bookPath;                   // Sách khai cuộc (rỗng = không dùng); chỉ áp cho ván cùng kích thước
+
+        Config() : workerCount(0), moveTime(1000), hashMegabytes(64), sharedHash(true),
+                   playStyle(AI::PlayStyle::BALANCED) {}
+    };
+
+    struct Metrics {
+        long long sessionsOpened;
+        long long sessionsActive;
+        long long queuedJobs;               // Đang chờ worker
+        long long runningJobs;              // Đang search
+        long long movesSearched;
+        long long nodes;
+        double uptimeSeconds;
+        double movesPerSecond;
+        double nodesPerSecond;
+        double searchAverageMs;
+        double queueAverageMs;              // Thời gian chờ từ lúc nhận lệnh tới lúc worker nhận việc
+        double queueP50Ms;                  // Phân vị trên LATENCY_WINDOW việc gần nhất
+        double queueP99Ms;
+        double queueMaxMs;                  // Từ lúc khởi động
+
+        Metrics() : sessionsOpened(0), sessionsActive(0), queuedJobs(0), runningJobs(0), movesSearched(0),
+                    nodes(0), uptimeSeconds(0.0), movesPerSecond(0.0), nodesPerSecond(0.0),
+                    searchAverageMs(0.0), queueAverageMs(0.0), queueP50Ms(0.0), queueP99Ms(0.0),
+                    queueMaxMs(0.0) {}
+    };
+
+    static const size_t LATENCY_WINDOW = 4096;
+
+    /**
+     * @param book Sách khai cuộc đã mở từ config.bookPath, dùng chung cho mọi worker (nullptr = không dùng)
+     */
+    explicit GameServer(std::ostream& out, const Config& config = Config(),
+                        std::shared_ptr<const OpeningBook> book = nullptr)
+        : out(out), config(config), startTime(Clock::now()), openingBook(std::move(book)), stopping(false),
+          runningJobs(0), sessionsOpened(0), movesSearched(0), totalNodes(0), totalQueueMicros(0),
+          totalSearchMicros(0), maxQueueMicros(0), latencyCursor(0) {
+        int workers = config.workerCount > 0 ? config.workerCount
+                                             : static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(1, workers);
+
+        if (config.sharedHash) {
+            sharedTable = std::make_shared<TranspositionTable>(config.hashMegabytes);
+        }
+        for (int i = 0; i < workers; i++) {
+            pool.emplace_back([this, workers]() { runWorker(workers); });
+        }
+    }
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    ~GameServer() {
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Xử lý một dòng lệnh; phản hồi đồng bộ được ghi ngay, kết quả search ghi từ worker
+     * @return false khi gặp lệnh quit
+     */
+    bool handleCommand(const std::string& line) {
+        std::istringstream in(line);
+        std::vector<std::string> args;
+        for (std::string token; in >> token;) {
+            args.push_back(token);
+        }
+        if (args.empty()) return true;
+
+        const std::string& command = args[0];
+        if (command == "quit") return false;
+        if (command == "stats") {
+            emit(formatMetrics(getMetrics()));
+            return true;
+        }
+        if (args.size() < 2) {
+            emit("error - missing game id");
+            return true;
+        }
+
+        const std::string& id = args[1];
+        auto argument = [&args](size_t index, long long fallback, long long& value) {
+            if (index >= args.size()) {
+                value = fallback;
+                return true;
+            }
+            return parseInteger(args[index], value);
+        };
+
+        if (command == "new") {
+            long long size, difficulty, aiPlayer;
+            if (!argument(2, Board::DEFAULT_SIZE, size) ||
+                !argument(3, static_cast<int>(AI::Difficulty::MEDIUM), difficulty) || !argument(4, 2, aiPlayer)) {
+                emit("error " + id + " expected: new <id> [size] [difficulty] [aiPlayer]");
+                return true;
+            }
+            openSession(id, size, difficulty, aiPlayer);
+        } else if (command == "play") {
+            long long row, col, moveMs;
+            if (args.size() < 4 || !argument(2, -1, row) || !argument(3, -1, col) ||
+                !argument(4, config.moveTime.count(), moveMs)) {
+                emit("error " + id + " expected: play <id> <row> <col> [moveMs]");
+                return true;
+            }
+            playMove(id, row, col, std::chrono::milliseconds(std::max(0LL, moveMs)));
+        } else if (command == "state") {
+            reportState(id);
+        } else if (command == "stop") {
+            stopSearch(id);
+        } else if (command == "close") {
+            closeSession(id);
+        } else {
+            emit("error " + id + " unknown command " + command);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Chờ tới khi không còn việc đang xếp hàng hoặc đang search
+     */
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex);
+        workDone.wait(lock, [this]() { return queue.empty() && runningJobs == 0; });
+    }
+
+    Metrics getMetrics() const {
+        Metrics metrics;
+        std::vector<long long> window;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            metrics.sessionsOpened = sessionsOpened;
+            metrics.sessionsActive = static_cast<long long>(sessions.size());
+            metrics.queuedJobs = static_cast<long long>(queue.size());
+            metrics.runningJobs = runningJobs;
+            metrics.movesSearched = movesSearched;
+            metrics.nodes = totalNodes;
+            if (movesSearched > 0) {
+                metrics.searchAverageMs = totalSearchMicros / 1000.0 / movesSearched;
+                metrics.queueAverageMs = totalQueueMicros / 1000.0 / movesSearched;
+            }
+            metrics.queueMaxMs = maxQueueMicros / 1000.0;
+            window = recentQueueMicros;
+        }
+
+        metrics.uptimeSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+        if (metrics.uptimeSeconds > 0.0) {
+            metrics.movesPerSecond = metrics.movesSearched / metrics.uptimeSeconds;
+            metrics.nodesPerSecond = metrics.nodes / metrics.uptimeSeconds;
+        }
+        if (!window.empty()) {
+            std::sort(window.begin(), window.end());
+            metrics.queueP50Ms = window[(window.size() - 1) / 2] / 1000.0;
+            metrics.queueP99Ms = window[(window.size() - 1) * 99 / 100] / 1000.0;
+        }
+        return metrics;
+    }
+
+    /**
+     * @brief Đọc số nguyên thập phân chiếm trọn token; false nếu có ký tự thừa ("7x") hoặc tràn
+     */
+    static bool parseInteger(const std::string& text, long long& value) {
+        if (text.empty()) return false;
+        errno = 0;
+        char* end = nullptr;
+        value = std::strtoll(text.c_str(), &end, 10);
+        return errno == 0 && *end == '\0';
+    }
+
+    static std::string formatMetrics(const Metrics& metrics) {
+        std::ostringstream line;
+        line << "stats sessions=" << metrics.sessionsActive << " opened=" << metrics.sessionsOpened
+             << " queued=" << metrics.queuedJobs << " running=" << metrics.runningJobs
+             << " moves=" << metrics.movesSearched << " nodes=" << metrics.nodes
+             << " uptime=" << metrics.uptimeSeconds << " movesPerSecond=" << metrics.movesPerSecond
+             << " nodesPerSecond=" << metrics.nodesPerSecond << " searchAvgMs=" << metrics.searchAverageMs
+             << " queueAvgMs=" << metrics.queueAverageMs << " queueP50Ms=" << metrics.queueP50Ms
+             << " queueP99Ms=" << metrics.queueP99Ms << " queueMaxMs=" << metrics.queueMaxMs;
+        return line.str();
+    }
+
+    static bool parseArguments(int argc, char** argv, Config& config) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+
+            if (arg == "--workers") {
+                config.workerCount = std::atoi(value.c_str());
+                if (config.workerCount < 0) return false;
+            } else if (arg == "--move-ms") {
+                config.moveTime = std::chrono::milliseconds(std::atoll(value.c_str()));
+                if (config.moveTime.count() < 0) return false;
+            } else if (arg == "--hash-mb") {
+                config.hashMegabytes = static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10));
+                if (config.hashMegabytes == 0) return false;
+            } else if (arg == "--hash") {
+                if (value == "shared") config.sharedHash = true;
+                else if (value == "worker") config.sharedHash = false;
+                else return false;
+            } else if (arg == "--book") {
+                config.bookPath = value;
+            } else if (arg == "--style") {
+                if (value == "balanced") config.playStyle = AI::PlayStyle::BALANCED;
+                else if (value == "aggressive") config.playStyle = AI::PlayStyle::AGGRESSIVE;
+                else if (value == "defensive") config.playStyle = AI::PlayStyle::DEFENSIVE;
+                else if (value == "positional") config.playStyle = AI::PlayStyle::POSITIONAL;
+                else return false;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * Trạng thái gọn của một ván; moves và result chỉ do worker đang giữ ván (busy) ghi
+     */
+    struct Session {
+        std::string id;
+        std::uint8_t size;
+        std::uint8_t aiPlayer;
+        AI::Difficulty difficulty;
+        bool busy;                              // Có việc đang chờ hoặc đang search
+        bool closed;                            // Đã close; phản hồi của việc còn dở bị bỏ
+        AI::StopToken stop;                     // Token của việc hiện tại, mới cho mỗi việc
+        GameLogic::GameState result;
+        std::vector<std::uint16_t> moves;       // row * size + col, người 1 đi trước
+
+        int humanPlayer() const noexcept { return aiPlayer == 1 ? 2 : 1; }
+    };
+
+    struct Job {
+        std::shared_ptr<Session> session;
+        bool humanMove;                         // false chỉ với nước đầu khi AI đi trước (new ... ai=1)
+        int row;                                // Nước của người chơi khi humanMove
+        int col;
+        Clock::time_point received;
+        std::chrono::milliseconds moveTime;     // 0 = search theo depth
+        AI::StopToken stop;
+    };
+
+    struct WorkerState {
+        Board board;
+        std::unique_ptr<AI> players[2];
+    };
+
+    std::ostream& out;
+    std::mutex outputMutex;
+    Config config;
+    Clock::time_point startTime;
+    std::shared_ptr<TranspositionTable> sharedTable;
+    std::shared_ptr<const OpeningBook> openingBook;
+
+    mutable std::mutex mutex;                   // Bảo vệ mọi thứ bên dưới
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    std::deque<Job> queue;
+    bool stopping;
+    long long runningJobs;
+
+    long long sessionsOpened;
+    long long movesSearched;
+    long long totalNodes;
+    long long totalQueueMicros;
+    long long totalSearchMicros;
+    long long maxQueueMicros;
+    std::vector<long long> recentQueueMicros;   // Vòng tròn LATENCY_WINDOW mẫu
+    size_t latencyCursor;
+
+    std::vector<std::thread> pool;              // Khai báo sau cùng: thread chỉ chạy khi mọi thành viên đã sẵn sàng
+
+    void emit(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        out << line << '\n';
+        out.flush();
+    }
+
+    static bool isValidDifficulty(long long difficulty) {
+        if (difficulty < 0 || difficulty > static_cast<int>(AI::Difficulty::EXPERT)) return false;
+        switch (static_cast<AI::Difficulty>(difficulty)) {
+            case AI::Difficulty::BEGINNER:
+            case AI::Difficulty::EASY:
+            case AI::Difficulty::MEDIUM:
+            case AI::Difficulty::HARD:
+            case AI::Difficulty::EXPERT:
+                return true;
+        }
+        return false;
+    }
+
+    void openSession(const std::string& id, long long size, long long difficulty, long long aiPlayer) {
+        if (size < Board::MIN_SIZE || size > Board::MAX_SIZE) {
+            emit("error " + id + " board size must be " + std::to_string(Board::MIN_SIZE) + ".." +
+                 std::to_string(Board::MAX_SIZE));
+            return;
+        }
+        if (!isValidDifficulty(difficulty) || (aiPlayer != 1 && aiPlayer != 2)) {
+            emit("error " + id + " invalid difficulty or ai player");
+            return;
+        }
+
+        auto session = std::make_shared<Session>();
+        session->id = id;
+        session->size = static_cast<std::uint8_t>(size);
+        session->aiPlayer = static_cast<std::uint8_t>(aiPlayer);
+        session->difficulty = static_cast<AI::Difficulty>(difficulty);
+        session->busy = false;
+        session->closed = false;
+        session->result = GameLogic::GameState::PLAYING;
+        bool created;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            created = sessions.emplace(id, session).second;
+            sessionsOpened += created ? 1 : 0;
+        }
+        if (!created) {
+            emit("error " + id + " game already exists");
+            return;
+        }
+        emit("ok new " + id);
+
+        if (aiPlayer == 1) {
+            schedule(session, false, -1, -1, config.moveTime);
+        }
+    }
+
+    void playMove(const std::string& id, long long row, long long col, std::chrono::milliseconds moveTime) {
+        if (row < 0 || col < 0 || row >= Board::MAX_SIZE || col >= Board::MAX_SIZE) {
+            emit("error " + id + " illegal move " + std::to_string(row) + " " + std::to_string(col));
+            return;
+        }
+
+        std::shared_ptr<Session> session;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = sessions.find(id);
+            if (it != sessions.end()) session = it->second;
+        }
+        if (!session) {
+            emit("error " + id + " unknown game");
+            return;
+        }
+        schedule(session, true, static_cast<int>(row), static_cast<int>(col), moveTime);
+    }
+
+    void schedule(const std::shared_ptr<Session>& session, bool humanMove, int row, int col,
+                  std::chrono::milliseconds moveTime) {
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (session->closed) {
+                error = "unknown game";
+            } else if (session->busy) {
+                error = "busy";
+            } else if (session->result != GameLogic::GameState::PLAYING) {
+                error = "game over";
+            } else {
+                session->busy = true;
+                session->stop = AI::StopToken();
+                queue.push_back(Job{session, humanMove, row, col, Clock::now(), moveTime, session->stop});
+            }
+        }
+
+        if (!error.empty()) {
+            emit("error " + session->id + " " + error);
+            return;
+        }
+        workAvailable.notify_one();
+    }
+
+    void reportState(const std::string& id) {
+        std::ostringstream line;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = sessions.find(id);
+            if (it == sessions.end()) {
+                line << "error " << id << " unknown game";
+            } else {
+                const Session& session = *it->second;
+                line << "state " << id << ' ' << GameLogic::gameStateToString(session.result) << ' '
+                     << session.moves.size() << ' ' << (session.busy ? 1 : 0);
+            }
+        }
+        emit(line.str());
+    }
+
+    /**
+     * Search của việc đang chờ hoặc đang chạy dừng trong vòng AI::STOP_CHECK_INTERVAL node
+     * và trả về nước của iteration đã xong gần nhất
+     */
+    void stopSearch(const std::string& id) {
+        std::string reply;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = sessions.find(id);
+            if (it == sessions.end()) {
+                reply = "error " + id + " unknown game";
+            } else if (!it->second->busy) {
+                reply = "error " + id + " not searching";
+            } else {
+                it->second->stop.requestStop();
+                reply = "ok stop " + id;
+            }
+        }
+        emit(reply);
+    }
+
+    /**
+     * Việc đang chờ của ván dừng sớm qua stop token (job giữ shared_ptr); ván được đánh dấu closed dưới mutex
+     * nên worker bỏ phản hồi của nó, id mở lại sau đó không nhận nhầm nước của ván cũ
+     */
+    void closeSession(const std::string& id) {
+        bool erased;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = sessions.find(id);
+            erased = it != sessions.end();
+            if (erased) {
+                it->second->closed = true;
+                it->second->stop.requestStop();
+                sessions.erase(it);
+            }
+        }
+        emit(erased ? "ok close " + id : "error " + id + " unknown game");
+    }
+
+    // ===== Worker =====
+
+    void runWorker(int workerCount) {
+        WorkerState state;
+        auto table = sharedTable ? sharedTable
+                                 : std::make_shared<TranspositionTable>(std::max<size_t>(1, config.hashMegabytes / workerCount));
+        for (int player = 1; player <= 2; player++) {
+            state.players[player - 1].reset(new AI(player, AI::Difficulty::MEDIUM, config.playStyle, table));
+            state.players[player - 1]->setOpeningBook(openingBook);
+        }
+
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workAvailable.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                job = std::move(queue.front());
+                queue.pop_front();
+                runningJobs++;
+            }
+
+            std::string response = runJob(job, state);
+
+            // Nhả ván trước khi trả lời để client gửi nước kế tiếp ngay không bị báo busy
+            bool closed;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job.session->busy = false;
+                closed = job.session->closed;
+                runningJobs--;
+            }
+            if (!closed) emit(response);
+            workDone.notify_all();
+        }
+    }
+
+    /**
+     * @return Dòng phản hồi của việc (move, end hoặc error)
+     */
+    std::string runJob(const Job& job, WorkerState& state) {
+        auto started = Clock::now();
+        long long queueMicros = std::chrono::duration_cast<std::chrono::microseconds>(started - job.received).count();
+        Session& session = *job.session;
+
+        Board& board = state.board;
+        replay(session, board);
+
+        if (job.humanMove) {
+            if (!board.makeMove(job.row, job.col, session.humanPlayer())) {
+                return "error " + session.id + " illegal move " + std::to_string(job.row) + " " + std::to_string(job.col);
+            }
+            GameLogic::GameState result = GameLogic::checkGameState(board);
+            record(session, job.row, job.col, result);
+            if (result != GameLogic::GameState::PLAYING) {
+                return "end " + session.id + " " + GameLogic::gameStateToString(result);
+            }
+        }
+
+        AI& ai = *state.players[session.aiPlayer - 1];
+        ai.setDifficulty(session.difficulty);
+
+        AI::SearchOptions options;
+        options.stopToken = job.stop;
+        if (job.moveTime.count() > 0) {
+            // Deadline tính từ lúc nhận lệnh; hết giờ khi đang chờ thì vẫn search tối thiểu 1ms
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                job.received + job.moveTime - Clock::now());
+            options.timeBudget = std::max(remaining, std::chrono::milliseconds(1));
+        }
+        AI::MoveEvaluation move = ai.findBestMove(board.getGrid(), options);
+
+        long long searchMicros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count();
+        long long nodes = ai.getLastThinkingStats().nodesEvaluated;
+
+        if (move.row < 0 || !board.makeMove(move.row, move.col, session.aiPlayer)) {
+            return "error " + session.id + " no move available";
+        }
+        GameLogic::GameState result = GameLogic::checkGameState(board);
+        record(session, move.row, move.col, result);
+        recordMetrics(queueMicros, searchMicros, nodes);
+
+        std::ostringstream line;
+        line << "move " << session.id << ' ' << move.row << ' ' << move.col << ' '
+             << GameLogic::gameStateToString(result) << ' ' << queueMicros / 1000.0 << ' '
+             << searchMicros / 1000.0 << ' ' << nodes;
+        return line.str();
+    }
+
+    static void replay(const Session& session, Board& board) {
+        if (board.getSize() != session.size) {
+            board.reset(session.size);
+        } else {
+            board.reset();
+        }
+
+        int player = 1;
+        for (std::uint16_t cell : session.moves) {
+            board.makeMove(cell / session.size, cell % session.size, player);
+            player = 3 - player;
+        }
+    }
+
+    void record(Session& session, int row, int col, GameLogic::GameState result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        session.moves.push_back(static_cast<std::uint16_t>(row * session.size + col));
+        session.result = result;
+    }
+
+    void recordMetrics(long long queueMicros, long long searchMicros, long long nodes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        movesSearched++;
+        totalNodes += nodes;
+        totalQueueMicros += queueMicros;
+        totalSearchMicros += searchMicros;
+        maxQueueMicros = std::max(maxQueueMicros, queueMicros);
+
+        if (recentQueueMicros.size() < LATENCY_WINDOW) {
+            recentQueueMicros.push_back(queueMicros);
+        } else {
+            recentQueueMicros[latencyCursor] = queueMicros;
+            latencyCursor = (latencyCursor + 1) % LATENCY_WINDOW;
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    GameServer::Config config;
+    if (!GameServer::parseArguments(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--workers N] [--move-ms MS] [--hash-mb MB] [--hash shared|worker]"
+                  << " [--style balanced|aggressive|defensive|positional] [--book FILE]" << std::endl;
+        return 2;
+    }
+
+    std::shared_ptr<const OpeningBook> book;
+    if (!config.bookPath.empty() && !(book = OpeningBook::load(config.bookPath))) {
+        std::cerr << "Cannot open opening book " << config.bookPath << std::endl;
+        return 1;
+    }
+
+    // cin mặc định tie với cout: mỗi lần đọc sẽ flush cout ngoài outputMutex trong khi worker đang ghi
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+    GameServer server(std::cout, config, book);
+
+    std::string line;
+    while (std::getline(std::cin, line) && server.handleCommand(line)) {
+    }
+    server.drain();
+    return 0;
+}
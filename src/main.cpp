@@ -2,384 +2,18 @@
 #include <iomanip>
 #include <vector>
 #include <string>
-#include <chrono>
 #include <sstream>
 #include <cassert>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <random>
 
-class Board {
-private:
-    int size;
-    std::vector<std::vector<int>> grid;
-    int moveCount;
-    int lastMoveRow, lastMoveCol, lastPlayer;
-
-public:
-    Board(int s = 15) : size(s), moveCount(0), lastMoveRow(-1), lastMoveCol(-1), lastPlayer(-1) {
-        grid.assign(size, std::vector<int>(size, 0));
-    }
-    
-    int getSize() const { return size; }
-    int getMoveCount() const { return moveCount; }
-    bool isEmpty() const { return moveCount == 0; }
-    
-    int getCell(int row, int col) const {
-        if (row < 0 || row >= size || col < 0 || col >= size) return -1;
-        return grid[row][col];
-    }
-    
-    bool makeMove(int row, int col, int player) {
-        if (row < 0 || row >= size || col < 0 || col >= size || grid[row][col] != 0) {
-            return false;
-        }
-        if (player != 1 && player != 2) return false;
-        
-        grid[row][col] = player;
-        moveCount++;
-        lastMoveRow = row;
-        lastMoveCol = col;
-        lastPlayer = player;
-        return true;
-    }
-    
-    bool undoLastMove() {
-        if (lastMoveRow < 0 || lastMoveCol < 0) return false;
-        
-        grid[lastMoveRow][lastMoveCol] = 0;
-        moveCount--;
-        lastMoveRow = lastMoveCol = lastPlayer = -1;
-        return true;
-    }
-    
-    void reset() {
-        for (auto& row : grid) {
-            std::fill(row.begin(), row.end(), 0);
-        }
-        moveCount = 0;
-        lastMoveRow = lastMoveCol = lastPlayer = -1;
-    }
-    
-    bool resize(int newSize) {
-        if (newSize < 15 || newSize > 100) return false;
-        
-        std::vector<std::vector<int>> newGrid(newSize, std::vector<int>(newSize, 0));
-        int copySize = std::min(size, newSize);
-        
-        for (int i = 0; i < copySize; i++) {
-            for (int j = 0; j < copySize; j++) {
-                newGrid[i][j] = grid[i][j];
-            }
-        }
-        
-        grid = std::move(newGrid);
-        size = newSize;
-        return true;
-    }
-    
-    const std::vector<std::vector<int>>& getGrid() const {
-        return grid;
-    }
-    
-    std::tuple<int, int, int> getLastMove() const {
-        return std::make_tuple(lastMoveRow, lastMoveCol, lastPlayer);
-    }
-    
-    double getOccupancyRate() const {
-        return static_cast<double>(moveCount) / (size * size);
-    }
-    
-    size_t getMemoryUsage() const {
-        return sizeof(*this) + size * size * sizeof(int);
-    }
-};
-
-class GameLogic {
-public:
-    enum class GameState { PLAYING, PLAYER1_WIN, PLAYER2_WIN, DRAW };
-    enum class MoveResult { VALID, OUT_OF_BOUNDS, CELL_OCCUPIED, INVALID_PLAYER };
-    
-    static MoveResult validateMove(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        if (player != 1 && player != 2) return MoveResult::INVALID_PLAYER;
-        
-        int size = board.size();
-        if (row < 0 || row >= size || col < 0 || col >= size) {
-            return MoveResult::OUT_OF_BOUNDS;
-        }
-        
-        if (board[row][col] != 0) return MoveResult::CELL_OCCUPIED;
-        
-        return MoveResult::VALID;
-    }
-    
-    static bool checkWin(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        if (row < 0 || col < 0 || board[row][col] != player) return false;
-        
-        int size = board.size();
-        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
-        
-        for (int dir = 0; dir < 4; dir++) {
-            int dx = directions[dir][0];
-            int dy = directions[dir][1];
-            int count = 1;
-            
-            int x = row + dx, y = col + dy;
-            while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-                count++;
-                x += dx;
-                y += dy;
-            }
-            
-            x = row - dx, y = col - dy;
-            while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-                count++;
-                x -= dx;
-                y -= dy;
-            }
-            
-            if (count >= 5) return true;
-        }
-        
-        return false;
-    }
-    
-    static GameState checkGameState(const std::vector<std::vector<int>>& board, int lastRow, int lastCol) {
-        if (lastRow >= 0 && lastCol >= 0) {
-            int lastPlayer = board[lastRow][lastCol];
-            if (checkWin(board, lastRow, lastCol, lastPlayer)) {
-                return (lastPlayer == 1) ? GameState::PLAYER1_WIN : GameState::PLAYER2_WIN;
-            }
-        }
-        
-        bool isFull = true;
-        for (const auto& row : board) {
-            for (int cell : row) {
-                if (cell == 0) {
-                    isFull = false;
-                    break;
-                }
-            }
-            if (!isFull) break;
-        }
-        
-        return isFull ? GameState::DRAW : GameState::PLAYING;
-    }
-    
-    static std::string gameStateToString(GameState state) {
-        switch (state) {
-            case GameState::PLAYING: return "PLAYING";
-            case GameState::PLAYER1_WIN: return "PLAYER1_WIN";
-            case GameState::PLAYER2_WIN: return "PLAYER2_WIN";
-            case GameState::DRAW: return "DRAW";
-            default: return "UNKNOWN";
-        }
-    }
-    
-    static std::string moveResultToString(MoveResult result) {
-        switch (result) {
-            case MoveResult::VALID: return "VALID";
-            case MoveResult::OUT_OF_BOUNDS: return "OUT_OF_BOUNDS";
-            case MoveResult::CELL_OCCUPIED: return "CELL_OCCUPIED";
-            case MoveResult::INVALID_PLAYER: return "INVALID_PLAYER";
-            default: return "UNKNOWN";
-        }
-    }
-};
-
-class AI {
-public:
-    enum class Difficulty { EASY = 2, MEDIUM = 4, HARD = 6 };
-    
-    struct MoveEvaluation {
-        int row, col, score;
-        MoveEvaluation(int r = -1, int c = -1, int s = 0) : row(r), col(c), score(s) {}
-    };
-
-private:
-    int aiPlayer, humanPlayer;
-    Difficulty difficulty;
-
-public:
-    AI(int ai = 2, Difficulty diff = Difficulty::MEDIUM) 
-        : aiPlayer(ai), difficulty(diff), humanPlayer(ai == 1 ? 2 : 1) {}
-    
-    MoveEvaluation findBestMove(const std::vector<std::vector<int>>& board) {
-        int size = board.size();
-        
-        bool isEmpty = true;
-        for (const auto& row : board) {
-            for (int cell : row) {
-                if (cell != 0) {
-                    isEmpty = false;
-                    break;
-                }
-            }
-            if (!isEmpty) break;
-        }
-        
-        if (isEmpty) {
-            return MoveEvaluation(size / 2, size / 2, 1000);
-        }
-        
-        std::vector<MoveEvaluation> candidates = generateCandidates(board);
-        if (candidates.empty()) {
-            return MoveEvaluation();
-        }
-        
-        MoveEvaluation bestMove;
-        int maxDepth = static_cast<int>(difficulty);
-        
-        for (auto& candidate : candidates) {
-            std::vector<std::vector<int>> tempBoard = board;
-            tempBoard[candidate.row][candidate.col] = aiPlayer;
-            
-            if (GameLogic::checkWin(tempBoard, candidate.row, candidate.col, aiPlayer)) {
-                return MoveEvaluation(candidate.row, candidate.col, 1000000);
-            }
-            
-            int score = minimax(tempBoard, maxDepth - 1, false, -999999, 999999);
-            if (score > bestMove.score) {
-                bestMove = MoveEvaluation(candidate.row, candidate.col, score);
-            }
-        }
-        
-        return bestMove;
-    }
-
-private:
-    std::vector<MoveEvaluation> generateCandidates(const std::vector<std::vector<int>>& board) {
-        std::vector<MoveEvaluation> candidates;
-        int size = board.size();
-        
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] == 0) {
-                    bool hasNearby = false;
-                    for (int di = -2; di <= 2 && !hasNearby; di++) {
-                        for (int dj = -2; dj <= 2 && !hasNearby; dj++) {
-                            int ni = i + di, nj = j + dj;
-                            if (ni >= 0 && ni < size && nj >= 0 && nj < size && board[ni][nj] != 0) {
-                                hasNearby = true;
-                            }
-                        }
-                    }
-                    if (hasNearby) {
-                        candidates.push_back(MoveEvaluation(i, j));
-                    }
-                }
-            }
-        }
-        
-        return candidates;
-    }
-    
-    int minimax(std::vector<std::vector<int>>& board, int depth, bool isMaximizing, int alpha, int beta) {
-        if (depth <= 0) {
-            return evaluateBoard(board);
-        }
-        
-        auto candidates = generateCandidates(board);
-        if (candidates.empty()) return evaluateBoard(board);
-        
-        if (isMaximizing) {
-            int maxEval = -999999;
-            for (const auto& move : candidates) {
-                board[move.row][move.col] = aiPlayer;
-                
-                if (GameLogic::checkWin(board, move.row, move.col, aiPlayer)) {
-                    board[move.row][move.col] = 0;
-                    return 999999 + depth;
-                }
-                
-                int eval = minimax(board, depth - 1, false, alpha, beta);
-                board[move.row][move.col] = 0;
-                
-                maxEval = std::max(maxEval, eval);
-                alpha = std::max(alpha, eval);
-                
-                if (beta <= alpha) break;
-            }
-            return maxEval;
-        } else {
-            int minEval = 999999;
-            for (const auto& move : candidates) {
-                board[move.row][move.col] = humanPlayer;
-                
-                if (GameLogic::checkWin(board, move.row, move.col, humanPlayer)) {
-                    board[move.row][move.col] = 0;
-                    return -999999 - depth;
-                }
-                
-                int eval = minimax(board, depth - 1, true, alpha, beta);
-                board[move.row][move.col] = 0;
-                
-                minEval = std::min(minEval, eval);
-                beta = std::min(beta, eval);
-                
-                if (beta <= alpha) break;
-            }
-            return minEval;
-        }
-    }
-    
-    int evaluateBoard(const std::vector<std::vector<int>>& board) {
-        int aiScore = 0, humanScore = 0;
-        int size = board.size();
-        
-        for (int i = 0; i < size; i++) {
-            for (int j = 0; j < size; j++) {
-                if (board[i][j] != 0) {
-                    int score = evaluatePosition(board, i, j, board[i][j]);
-                    if (board[i][j] == aiPlayer) {
-                        aiScore += score;
-                    } else {
-                        humanScore += score;
-                    }
-                }
-            }
-        }
-        
-        return aiScore - humanScore;
-    }
-    
-    int evaluatePosition(const std::vector<std::vector<int>>& board, int row, int col, int player) {
-        int score = 0;
-        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
-        
-        for (int dir = 0; dir < 4; dir++) {
-            int dx = directions[dir][0];
-            int dy = directions[dir][1];
-            
-            int count = countLine(board, row, col, dx, dy, player);
-            if (count >= 5) score += 100000;
-            else if (count == 4) score += 10000;
-            else if (count == 3) score += 1000;
-            else if (count == 2) score += 100;
-            else score += 10;
-        }
-        
-        return score;
-    }
-    
-    int countLine(const std::vector<std::vector<int>>& board, int row, int col, int dx, int dy, int player) {
-        int size = board.size();
-        int count = 1;
-        
-        int x = row + dx, y = col + dy;
-        while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-            count++;
-            x += dx;
-            y += dy;
-        }
-        
-        x = row - dx, y = col - dy;
-        while (x >= 0 && x < size && y >= 0 && y < size && board[x][y] == player) {
-            count++;
-            x -= dx;
-            y -= dy;
-        }
-        
-        return count;
-    }
-};
+#include "ai.cpp"
+#include "gamerecord.cpp"
+#include "openingbook.cpp"
+#include "sparseboard.cpp"
+#include "batchanalyzer.cpp"
 
 class GameTester {
 private:
@@ -424,6 +58,16 @@ public:
         
         assert_test(board.resize(25), "Resize board");
         assert_test(board.getSize() == 25, "Size after resize");
+
+        // Lật cột (col -> 14 - col) không đổi khóa chuẩn
+        Board original(15), mirrored(15);
+        original.makeMove(3, 4, 1);
+        original.makeMove(5, 9, 2);
+        mirrored.makeMove(3, 10, 1);
+        mirrored.makeMove(5, 5, 2);
+        int originalSymmetry, mirroredSymmetry;
+        assert_test(original.getCanonicalKey(originalSymmetry) == mirrored.getCanonicalKey(mirroredSymmetry),
+                    "Canonical key of mirrored board");
     }
     
     static void test_gamelogic() {
@@ -432,19 +76,20 @@ public:
         Board board(15);
         // Test move validation
         
-        auto result = GameLogic::validateMove({{0}}, 0, 0, 1);
+        auto result = GameLogic::validateMove(board.getGrid(), 0, 0, 1);
         assert_test(result == GameLogic::MoveResult::VALID, "Valid move validation");
         
-        // Create test grid for win detection
-        std::vector<std::vector<int>> testGrid(15, std::vector<int>(15, 0));
+        // Create test board for win detection
         for (int i = 0; i < 5; i++) {
-            testGrid[7][5 + i] = 1;
+            board.makeMove(7, 5 + i, 1);
         }
         
-        assert_test(GameLogic::checkWin(testGrid, 7, 7, 1), "Win detection");
+        assert_test(GameLogic::checkWinAtPosition(board, 7, 7, 1), "Win detection");
+        assert_test(GameLogic::checkWinAtPosition(board.getGrid(), 7, 7, 1), "Win detection (view)");
         
-        auto state = GameLogic::checkGameState(testGrid, 7, 9);
+        auto state = GameLogic::checkGameState(board, 7, 9);
         assert_test(state == GameLogic::GameState::PLAYER1_WIN, "Game state win");
+        assert_test(GameLogic::checkGameState(board.getGrid(), 7, 9) == state, "Game state win (view)");
     }
     
     static void test_ai() {
@@ -454,32 +99,343 @@ public:
         Board board(15);
         board.makeMove(7, 7, 1);
         
-        std::vector<std::vector<int>> grid(15, std::vector<int>(15, 0));
-        grid[7][7] = 1;
-        
-        auto move = ai.findBestMove(grid);
+        auto move = ai.findBestMove(board.getGrid());
         assert_test(move.row >= 0 && move.col >= 0, "AI move generation");
         assert_test(move.row < 15 && move.col < 15, "AI move bounds");
         
-        auto centerMove = ai.findBestMove(std::vector<std::vector<int>>(15, std::vector<int>(15, 0)));
+        auto centerMove = ai.findBestMove(Board(15).getGrid());
         assert_test(centerMove.row == 7 && centerMove.col == 7, "AI center opening");
     }
     
-    static void benchmark() {
-        std::cout << "\nBenchmarking..." << std::endl;
+    static void test_search_options() {
+        std::cout << "\nTesting AI::SearchOptions..." << std::endl;
         
-        auto start = std::chrono::high_resolution_clock::now();
+        Board board(15);
+        board.makeMove(7, 7, 1);
+        board.makeMove(8, 8, 2);
+        board.makeMove(6, 8, 1);
         
-        Board board(50);
-        for (int i = 0; i < 1000; i++) {
-            board.makeMove(i % 50, (i * 7) % 50, (i % 2) + 1);
+        AI ai(2, AI::Difficulty::MEDIUM);
+        std::vector<AI::SearchProgress> progress;
+        AI::SearchOptions options;
+        options.depthLimit = 3;
+        options.onProgress = [&progress](const AI::SearchProgress& update) { progress.push_back(update); };
+        AI::MoveEvaluation move = ai.findBestMove(board.getGrid(), options);
+        bool oncePerDepth = progress.size() == 3;
+        for (size_t i = 0; oncePerDepth && i < progress.size(); i++) {
+            oncePerDepth = progress[i].bestMove.depth == static_cast<int>(i) + 1 && progress[i].nodes > 0;
         }
+        assert_test(oncePerDepth && move.depth == 3, "onProgress once per completed depth");
+        
+        // Tiếp tục cùng vị trí: chỉ còn depth 4 (depth của MEDIUM)
+        progress.clear();
+        options.depthLimit = 0;
+        options.resume = true;
+        move = ai.findBestMove(board.getGrid(), options);
+        assert_test(progress.size() == 1 && progress[0].bestMove.depth == 4 && move.depth == 4,
+                    "Resume starts after the completed depth");
+        
+        // Dừng giữa search: trả về nước của iteration cuối đã xong
+        progress.clear();
+        options.resume = false;
+        AI::StopToken stop = options.stopToken;
+        options.onProgress = [&progress, stop](const AI::SearchProgress& update) {
+            progress.push_back(update);
+            if (update.bestMove.depth == 2) stop.requestStop();
+        };
+        move = ai.findBestMove(board.getGrid(), options);
+        assert_test(progress.size() == 2 && move.depth == 2 && move.row == progress[1].bestMove.row &&
+                    move.col == progress[1].bestMove.col, "Stop token keeps last completed iteration");
+        
+        // Token đã bật từ trước: không xong iteration nào nhưng vẫn có nước hợp lệ
+        progress.clear();
+        AI::SearchOptions stopped;
+        stopped.stopToken.requestStop();
+        move = ai.findBestMove(board.getGrid(), stopped);
+        assert_test(move.row >= 0 && board.isValidMove(move.row, move.col) && move.depth == 0 &&
+                    ai.getLastThinkingStats().maxDepthReached == 0, "Pre-set stop token");
+    }
+    
+    static void test_threatsearch() {
+        std::cout << "\nTesting ThreatSearch..." << std::endl;
         
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        // X có 3 ngang chặn trái ở hàng 7, 2 dọc chặn trên ở cột 7 và 3 gãy chặn phải ở hàng 6:
+        // (6,7) tạo 4 gãy buộc O chặn (6,8), rồi (7,7) tạo hai thế 4. Đi (7,7) trước cũng thắng
+        Board board(15);
+        const int attacker[][2] = {{7, 4}, {7, 5}, {7, 6}, {4, 7}, {5, 7}, {6, 9}, {6, 10}, {6, 11}};
+        const int defender[][2] = {{7, 3}, {3, 7}, {6, 12}, {0, 0}, {0, 14}, {14, 0}, {14, 14}, {1, 1}};
+        for (int i = 0; i < 8; i++) {
+            board.makeMove(attacker[i][0], attacker[i][1], 1);
+            board.makeMove(defender[i][0], defender[i][1], 2);
+        }
+        const std::uint64_t key = board.getHashKey();
+        
+        ThreatSearch solver;
+        ThreatSearch::Result shallow = solver.solve(board, 1, ThreatSearch::Limits(1, false));
+        ThreatSearch::Result vcf = solver.solve(board, 1, ThreatSearch::Limits(6, false));
+        bool firstMoveWins = vcf.found && vcf.depth == 2 &&
+                             ((vcf.row == 6 && vcf.col == 7) || (vcf.row == 7 && vcf.col == 7));
+        assert_test(!shallow.found && firstMoveWins, "VCF broken four into double four");
+        assert_test(board.getHashKey() == key && board.getMoveCount() == 16, "Board restored after solve");
+        
+        // Đi tiếp chuỗi: O chặn ô hoàn thành 5 duy nhất, X còn VCF 1 nước (hai thế 4)
+        bool followUp = board.makeMove(vcf.row, vcf.col, 1);
+        int blocks = 0;
+        for (int row = 0; row < 15; row++) {
+            for (int col = 0; col < 15; col++) {
+                if (board.makesFive(row, col, 1)) {
+                    blocks++;
+                    followUp = followUp && board.makeMove(row, col, 2);
+                }
+            }
+        }
+        ThreatSearch::Result finish = solver.solve(board, 1, ThreatSearch::Limits(1, false));
+        assert_test(followUp && blocks == 1 && finish.found && finish.depth == 1, "VCF line plays out");
+        board.undoMoves(2);
+        
+        ThreatSearch::Result defence = solver.solve(board, 2, ThreatSearch::Limits(8, true));
+        Board quiet(15);
+        quiet.makeMove(7, 7, 1);
+        quiet.makeMove(8, 8, 2);
+        quiet.makeMove(9, 9, 1);
+        ThreatSearch::Result nothing = solver.solve(quiet, 1, ThreatSearch::Limits(8, true));
+        assert_test(!defence.found && !nothing.found, "No forced win reported");
+        
+        std::atomic<bool> stop(true);
+        ThreatSearch::Result stopped = solver.solve(board, 1, ThreatSearch::Limits(6, false),
+                                                    std::chrono::steady_clock::time_point::max(), &stop);
+        bool stopEnds = !stopped.found && solver.getStats().timedOut;
+        ThreatSearch::Result late = solver.solve(board, 1, ThreatSearch::Limits(6, false),
+                                                 std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+        assert_test(stopEnds && !late.found && solver.getStats().timedOut, "Stop flag and deadline end solve");
+    }
+    
+    static void test_gamerecord() {
+        std::cout << "\nTesting GameRecord..." << std::endl;
+        
+        const std::string path = (std::filesystem::temp_directory_path() / "caro_gametester.rec").string();
+        Board first(15), second(19);
+        first.makeMove(7, 7, 1);
+        first.makeMove(7, 8, 2);
+        first.makeMove(8, 8, 1);
+        second.makeMove(0, 18, 2);
+        second.makeMove(18, 0, 1);
+        
+        GameRecordWriter writer;
+        bool written = writer.open(path) && writer.write(first, GameLogic::GameState::PLAYING) &&
+                       writer.write(second, GameLogic::GameState::DRAW);
+        writer.close();
+        assert_test(written, "Write records");
+        
+        GameRecordReader reader;
+        GameRecordReader::Game game;
+        Board replayed(15);
+        bool firstMatches = reader.open(path) && reader.next(game) &&
+                            game.getResult() == GameLogic::GameState::PLAYING &&
+                            game.replay(replayed) && replayed.getMoveHistory() == first.getMoveHistory();
+        bool secondMatches = reader.next(game) && game.getFirstPlayer() == 2 &&
+                             game.getResult() == GameLogic::GameState::DRAW && game.replay(replayed) &&
+                             replayed.getSize() == 19 && replayed.getMoveHistory() == second.getMoveHistory();
+        assert_test(firstMatches && secondMatches && !reader.next(game) && !reader.isCorrupt(),
+                    "Record round trip");
+        reader.close();
+        
+        // Hỏng byte kết quả của ván đầu
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(GameRecord::FILE_HEADER_SIZE + 1));
+            file.put(static_cast<char>(0x7F));
+        }
+        assert_test(reader.open(path) && !reader.next(game) && reader.isCorrupt(), "Corrupt record detected");
+        reader.close();
+        std::remove(path.c_str());
+    }
+    
+    static void test_openingbook() {
+        std::cout << "\nTesting OpeningBook..." << std::endl;
+        
+        const std::string path = (std::filesystem::temp_directory_path() / "caro_gametester.book").string();
+        OpeningBookBuilder builder(15, 8);
+        bool added = builder.addGame(15, {{7, 7, 1}, {6, 8, 2}, {8, 6, 1}, {5, 9, 2}}, GameLogic::GameState::PLAYER1_WIN) &&
+                     !builder.addGame(19, {{9, 9, 1}}, GameLogic::GameState::PLAYER1_WIN);
+        assert_test(added && builder.save(path), "Build and write book");
+        
+        OpeningBook book;
+        assert_test(book.open(path) && book.isMemoryMapped() && book.getBoardSize() == 15 && book.getMaxPly() == 8,
+                    "Open book via mmap");
+        
+        // Vị trí gốc, bản lật cột và bản xoay 90 độ (r, c) -> (c, 14 - r): nước trả về theo hướng thật
+        auto probeAt = [&book](std::initializer_list<std::pair<int, int>> moves, int expectedRow, int expectedCol) {
+            Board board(15);
+            int player = 1;
+            for (const auto& [row, col] : moves) {
+                board.makeMove(row, col, player);
+                player = 3 - player;
+            }
+            OpeningBook::Entry entry;
+            return book.probe(board, player, entry) && entry.row == expectedRow && entry.col == expectedCol &&
+                   entry.weight == 2;
+        };
+        assert_test(probeAt({{7, 7}, {6, 8}}, 8, 6), "Probe book position");
+        assert_test(probeAt({{7, 7}, {6, 6}}, 8, 8) && probeAt({{7, 7}, {8, 8}}, 6, 6),
+                    "Probe mirrored and rotated position");
+        
+        Board other(19), unknown(15);
+        other.makeMove(9, 9, 1);
+        other.makeMove(8, 10, 2);
+        unknown.makeMove(7, 7, 1);
+        unknown.makeMove(0, 0, 2);
+        OpeningBook::Entry entry;
+        assert_test(!book.probe(other, 1, entry) && !book.probe(unknown, 1, entry), "Book misses other size and unknown position");
+        book.close();
+        
+        // Header hỏng: kích thước bàn ngoài phạm vi, entryCount vượt load 1/2, file cắt cụt
+        auto corrupted = [&path](std::streamoff offset, char value) {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekg(offset);
+            char original = static_cast<char>(file.get());
+            file.seekp(offset);
+            file.put(value);
+            file.close();
+            OpeningBook probe;
+            bool rejected = !probe.open(path);
+            probe.close();
+            file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(offset);
+            file.put(original);
+            return rejected;
+        };
+        bool sizeRejected = corrupted(5, 5);
+        bool countRejected = corrupted(15, 0x40);
+        bool magicRejected = corrupted(0, 'X');
+        std::filesystem::resize_file(path, OpeningBook::HEADER_SIZE + OpeningBook::SLOT_SIZE);
+        assert_test(sizeRejected && countRejected && magicRejected && !book.open(path) &&
+                    OpeningBook::load(path) == nullptr, "Corrupt book rejected");
+        std::remove(path.c_str());
+    }
+    
+    static void test_sparseboard() {
+        std::cout << "\nTesting SparseBoard..." << std::endl;
+        
+        // 19x19 để tile 16x16 bị cắt ở biên; đánh và undo ngẫu nhiên song song với Board
+        const int size = 19;
+        Board board(size);
+        SparseBoard sparse(size);
+        std::mt19937 rng(12345);
+        bool cellsMatch = true, winsMatch = true, candidatesMatch = true, stateValid = true;
+        for (int step = 0; step < 400; step++) {
+            if (board.getMoveCount() > 0 && rng() % 4 == 0) {
+                cellsMatch &= board.undoLastMove() == sparse.undoLastMove();
+            } else {
+                int row = static_cast<int>(rng() % size), col = static_cast<int>(rng() % size);
+                int player = board.getMoveCount() % 2 + 1;
+                cellsMatch &= board.makeMove(row, col, player) == sparse.makeMove(row, col, player);
+            }
+            
+            for (int row = 0; row < size; row++) {
+                for (int col = 0; col < size; col++) {
+                    cellsMatch &= board.getCell(row, col) == sparse.getCell(row, col);
+                    candidatesMatch &= board.isCandidateCell(row, col) == sparse.isCandidateCell(row, col);
+                    for (int player = 1; player <= 2; player++) {
+                        winsMatch &= board.makesFive(row, col, player) == sparse.makesFive(row, col, player);
+                        winsMatch &= board.hasFiveAt(row, col, player) == sparse.hasFiveAt(row, col, player);
+                    }
+                }
+            }
+            cellsMatch &= board.getMoveCount() == sparse.getMoveCount() &&
+                          board.getMoveHistory() == sparse.getMoveHistory();
+            stateValid &= sparse.validateState();
+        }
+        assert_test(cellsMatch, "SparseBoard cells match Board");
+        assert_test(winsMatch, "SparseBoard five detection matches Board");
+        assert_test(candidatesMatch, "SparseBoard candidates match Board");
+        assert_test(stateValid, "SparseBoard state valid after moves and undo");
+        
+        // Ô xa trên bàn 2^30 chỉ cấp phát vài tile
+        SparseBoard huge;
+        const int far = SparseBoard::MAX_SIZE - 3;
+        assert_test(huge.makeMove(far, far, 1) && huge.makeMove(0, 0, 2) && huge.getCell(far, far) == 1 &&
+                    huge.undoMoves(2) && huge.isEmpty() && huge.validateState(), "SparseBoard far corners");
+    }
+    
+    static void test_lineruns() {
+        std::cout << "\nTesting LineRuns..." << std::endl;
+        
+        // Ô liền trước theo chiều forward của mỗi hướng (HORIZONTAL, VERTICAL, DIAGONAL, ANTI_DIAGONAL)
+        const int previous[LineRuns::DIRECTION_COUNT][2] = {{0, -1}, {-1, 0}, {-1, -1}, {-1, 1}};
+        auto countRun = [](const Board& board, int row, int col, int dr, int dc, int player) {
+            int count = 0;
+            while (board.getCell(row, col) == player) {
+                count++;
+                row += dr;
+                col += dc;
+            }
+            return count;
+        };
+        
+        std::mt19937 rng(2024);
+        bool scalarMatches = true, dispatchedMatches = true;
+        for (int size : {Board::MIN_SIZE, 15, 33, Board::MAX_SIZE}) {
+            Board board(size);
+            for (int i = 0; i < size * size / 2; i++) {
+                board.makeMove(static_cast<int>(rng() % size), static_cast<int>(rng() % size),
+                               static_cast<int>(rng() % 2) + 1);
+            }
+            
+            for (int player = 1; player <= 2; player++) {
+                LineRuns scalar, dispatched;
+                scalar.compute(board.getGrid(), player, LineRuns::Isa::SCALAR);
+                dispatched.compute(board.getGrid(), player);
+                for (int dir = 0; dir < LineRuns::DIRECTION_COUNT; dir++) {
+                    int dr = previous[dir][0], dc = previous[dir][1];
+                    for (int row = 0; row < size; row++) {
+                        for (int col = 0; col < size; col++) {
+                            int forward = countRun(board, row, col, dr, dc, player);
+                            int backward = countRun(board, row, col, -dr, -dc, player);
+                            scalarMatches &= scalar.forward(dir, row, col) == forward &&
+                                             scalar.backward(dir, row, col) == backward;
+                            dispatchedMatches &= dispatched.forward(dir, row, col) == scalar.forward(dir, row, col) &&
+                                                 dispatched.backward(dir, row, col) == scalar.backward(dir, row, col);
+                        }
+                    }
+                }
+            }
+        }
+        assert_test(scalarMatches, "LineRuns scalar matches brute force");
+        assert_test(dispatchedMatches, "LineRuns dispatched ISA matches scalar");
+    }
+    
+    static void test_batchanalyzer() {
+        std::cout << "\nTesting BatchAnalyzer..." << std::endl;
+        
+        using Position = BatchAnalyzer::Position;
+        using History = BatchAnalyzer::MoveHistory;
+        std::vector<Position> positions = {
+            Position(15, History{{7, 7, 1}}),
+            Position(15, History{{7, 7, 1}, {6, 8, 2}, {8, 8, 1}}),
+            Position(15, History{{7, 7, 1}, {6, 6, 2}, {8, 6, 1}}),   // Lật cột của vị trí trên
+            Position(15, History{{7, 7, 1}, {7, 7, 2}}),              // Lịch sử lỗi
+            Position(19, History{{9, 9, 1}, {9, 10, 2}})
+        };
+        
+        BatchAnalyzer::Config config;
+        config.difficulty = AI::Difficulty::EASY;
+        config.workerCount = 1;
+        BatchAnalyzer::Report single = BatchAnalyzer(config).analyze(positions);
+        config.workerCount = 3;
+        BatchAnalyzer::Report pooled = BatchAnalyzer(config).analyze(positions);
+        
+        bool sameMoves = single.moves.size() == positions.size() && pooled.moves.size() == positions.size();
+        for (size_t i = 0; sameMoves && i < positions.size(); i++) {
+            sameMoves = single.moves[i].row == pooled.moves[i].row && single.moves[i].col == pooled.moves[i].col;
+        }
+        assert_test(sameMoves && pooled.workerCount == 3, "BatchAnalyzer results independent of worker count");
+        assert_test(single.failedPositions == 1 && single.moves[3].row == -1, "BatchAnalyzer rejects invalid history");
         
-        std::cout << "1000 moves on 50x50 board: " << duration.count() << "ms" << std::endl;
-        std::cout << "Memory usage: " << board.getMemoryUsage() / 1024 << " KB" << std::endl;
+        config.mergeSymmetric = true;
+        BatchAnalyzer::Report merged = BatchAnalyzer(config).analyze(positions);
+        assert_test(merged.mergedPositions == 1 && merged.moves[2].row == merged.moves[1].row &&
+                    merged.moves[2].col == 14 - merged.moves[1].col, "BatchAnalyzer merges mirrored positions");
     }
 };
 
@@ -489,9 +445,13 @@ private:
     AI ai;
     bool vsAI;
     int currentPlayer;
+    bool ponderHit;         // Người chơi vừa đi đúng nước AI đang ponder
 
 public:
-    ConsoleGame() : board(15), ai(2), vsAI(false), currentPlayer(1) {}
+    explicit ConsoleGame(std::shared_ptr<const OpeningBook> book = nullptr)
+        : board(15), ai(2), vsAI(false), currentPlayer(1), ponderHit(false) {
+        ai.setOpeningBook(std::move(book));
+    }
     
     void displayBoard() {
         int size = board.getSize();
@@ -531,8 +491,7 @@ public:
         while (true) {
             displayBoard();
             
-            auto [lastRow, lastCol, lastPlayer] = board.getLastMove();
-            auto state = GameLogic::checkGameState(board.getGrid(), lastRow, lastCol);
+            auto state = GameLogic::checkGameState(board);
             
             if (state != GameLogic::GameState::PLAYING) {
                 std::cout << "Game Over: " << GameLogic::gameStateToString(state) << std::endl;
@@ -547,16 +506,21 @@ public:
                 
                 if (board.makeMove(row, col, currentPlayer)) {
                     std::cout << "Move accepted" << std::endl;
+                    // Đoán trúng thì search nền chạy tiếp; đoán trượt thì ponderHit tự hủy nó
+                    ponderHit = vsAI && ai.ponderHit(row, col);
                 } else {
                     std::cout << "Invalid move" << std::endl;
                     continue;
                 }
             } else {
                 std::cout << "AI thinking..." << std::endl;
-                auto move = ai.findBestMove(board.getGrid());
+                auto move = ponderHit ? ai.waitForSearch() : ai.findBestMove(board.getGrid());
+                ponderHit = false;
                 
                 if (move.row >= 0 && board.makeMove(move.row, move.col, currentPlayer)) {
                     std::cout << "AI played: " << move.row << " " << move.col << std::endl;
+                    // Nghĩ tiếp trên nước trả lời dự đoán trong lúc chờ người chơi nhập
+                    ai.startPondering(board.getGrid());
                 }
             }
             
@@ -568,13 +532,25 @@ public:
 int GameTester::totalTests = 0;
 int GameTester::passedTests = 0;
 
-int main() {
+int main(int argc, char** argv) {
+    // Usage: main [--book FILE]   (sách khai cuộc cho AI của Play Game, build bằng caro_book)
+    std::shared_ptr<const OpeningBook> book;
+    if (argc == 3 && std::string(argv[1]) == "--book") {
+        book = OpeningBook::load(argv[2]);
+        if (!book) {
+            std::cerr << "Cannot open opening book " << argv[2] << std::endl;
+            return 1;
+        }
+    } else if (argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--book FILE]" << std::endl;
+        return 2;
+    }
+    
     std::cout << "Caro Game Core Library Test" << std::endl;
     std::cout << "===========================" << std::endl;
     
     std::cout << "1. Run Tests" << std::endl;
     std::cout << "2. Play Game" << std::endl;
-    std::cout << "3. Run Benchmark" << std::endl;
     
     int choice;
     std::cin >> choice;
@@ -584,19 +560,22 @@ int main() {
             GameTester::test_board();
             GameTester::test_gamelogic();
             GameTester::test_ai();
+            GameTester::test_search_options();
+            GameTester::test_threatsearch();
+            GameTester::test_gamerecord();
+            GameTester::test_openingbook();
+            GameTester::test_sparseboard();
+            GameTester::test_lineruns();
+            GameTester::test_batchanalyzer();
             GameTester::print_summary();
             break;
             
         case 2: {
-            ConsoleGame game;
+            ConsoleGame game(book);
             game.play();
             break;
         }
         
-        case 3:
-            GameTester::benchmark();
-            break;
-            
         default:
             std::cout << "Invalid choice" << std::endl;
             break;
@@ -0,0 +1,355 @@
+// openingbook.cpp - Opening Book
+// Người 1: Logic & AI - Bảng khai cuộc tra O(1) theo Zobrist hash chuẩn hóa qua 8 phép đối xứng
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <random>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+#include "board.cpp"
+#include "zobrist.cpp"
+#include "gamelogic.cpp"
+#include "gamerecord.cpp"
+
+/**
+ * @class OpeningBook
+ * @brief Read-only position -> move table, memory-mapped from a book file
+ *
+ * Khóa của vị trí = nhỏ nhất trong 8 khóa Zobrist đối xứng (cộng sideKey nếu người 2 sắp đi),
+ * nên 8 vị trí đối xứng dùng chung một entry. Nước đi được lưu trong hệ tọa độ chuẩn
+ * và biến đổi ngược về bàn thật khi tra.
+ *
+ * File: header 16 byte ("CBOK", version, boardSize u8, maxPly u16, slotCount u32, entryCount u32)
+ * rồi slotCount slot 16 byte (key u64, move u16, weight u16, dự trữ u32), little-endian.
+ * slotCount là lũy thừa của 2 và bảng được điền theo linear probing với load <= 1/2,
+ * nên probe() đọc thẳng trên vùng mmap, trung bình ~1-2 slot; key = 0 là slot trống.
+ * Sách chỉ dùng cho đúng kích thước bàn lúc build: khoảng cách tới biên và hệ tọa độ
+ * đối xứng khác nhau giữa các kích thước.
+ */
+class OpeningBook {
+public:
+    static const int NO_MOVE = 0xFFFF;
+    static const std::uint8_t VERSION = 2;             // 2: header ghi boardSize
+    static const size_t HEADER_SIZE = 16;
+    static const size_t SLOT_SIZE = 16;
+
+    struct Entry {
+        int row;
+        int col;
+        int weight;                         // Số lần (có trọng số) nước này được chọn khi build
+
+        Entry() : row(-1), col(-1), weight(0) {}
+    };
+
+    OpeningBook() : boardSize(0), maxPly(0), slotCount(0), entryCount(0) {}
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        if (!file.open(path, MappedFile::Access::RANDOM)) return false;
+
+        const std::uint8_t* data = file.data();
+        if (file.size() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[4] != VERSION) {
+            close();
+            return false;
+        }
+
+        boardSize = data[5];
+        maxPly = readU16(data + 6);
+        slotCount = readU32(data + 8);
+        entryCount = readU32(data + 12);
+        // Load <= 1/2 bảo đảm còn slot trống để probe() dừng; file hỏng hay cắt cụt bị từ chối
+        bool powerOfTwo = slotCount > 0 && (slotCount & (slotCount - 1)) == 0;
+        if (!powerOfTwo || boardSize < Board::MIN_SIZE || boardSize > Board::MAX_SIZE ||
+            static_cast<std::uint64_t>(entryCount) * 2 > slotCount ||
+            file.size() < HEADER_SIZE + static_cast<size_t>(slotCount) * SLOT_SIZE) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Mở sách để dùng chung giữa nhiều AI; nullptr nếu không mở được
+     */
+    static std::shared_ptr<const OpeningBook> load(const std::string& path) {
+        auto book = std::make_shared<OpeningBook>();
+        if (!book->open(path)) return nullptr;
+        return book;
+    }
+
+    void close() {
+        file.close();
+        boardSize = 0;
+        maxPly = 0;
+        slotCount = 0;
+        entryCount = 0;
+    }
+
+    bool isOpen() const noexcept { return file.isOpen(); }
+    bool isMemoryMapped() const noexcept { return file.isMemoryMapped(); }
+    int getBoardSize() const noexcept { return boardSize; }
+    int getMaxPly() const noexcept { return maxPly; }
+    size_t getEntryCount() const noexcept { return entryCount; }
+
+    /**
+     * @brief Khóa chuẩn hóa của vị trí khi toMove sắp đi, và phép đối xứng đưa bàn về hệ chuẩn
+     */
+    static std::uint64_t canonicalKey(const Board& board, int toMove, int& symmetry) noexcept {
+        return board.getCanonicalKey(symmetry, toMove == 2 ? Zobrist::sideKey() : 0);
+    }
+
+    /**
+     * @brief Tra nước sách cho toMove; false nếu vị trí không có trong sách, quá maxPly
+     *        hoặc bàn khác kích thước của sách
+     */
+    bool probe(const Board& board, int toMove, Entry& entry) const noexcept {
+        if (!isOpen() || board.getSize() != boardSize || board.getMoveCount() >= maxPly) return false;
+
+        int symmetry;
+        std::uint64_t key = canonicalKey(board, toMove, symmetry);
+        if (key == 0) return false;
+
+        // Giới hạn slotCount lần dò: header đúng mà vùng slot bị sửa vẫn không lặp vô hạn
+        const std::uint8_t* slots = file.data() + HEADER_SIZE;
+        std::uint32_t i = static_cast<std::uint32_t>(key) & (slotCount - 1);
+        for (std::uint32_t probes = 0; probes < slotCount; probes++, i = (i + 1) & (slotCount - 1)) {
+            const std::uint8_t* slot = slots + static_cast<size_t>(i) * SLOT_SIZE;
+            std::uint64_t slotKey = readU64(slot);
+            if (slotKey == 0) return false;
+            if (slotKey != key) continue;
+
+            int move = readU16(slot + 8);
+            if (move == NO_MOVE) return false;
+
+            int row, col;
+            BoardSymmetry::apply(BoardSymmetry::inverse(symmetry), board.getSize(),
+                                 move / Board::MAX_SIZE, move % Board::MAX_SIZE, row, col);
+            if (board.getCell(row, col) != Board::EMPTY) return false;
+
+            entry.row = row;
+            entry.col = col;
+            entry.weight = readU16(slot + 10);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    friend class OpeningBookBuilder;
+    static constexpr char MAGIC[4] = {'C', 'B', 'O', 'K'};
+
+    MappedFile file;
+    int boardSize;
+    int maxPly;
+    std::uint32_t slotCount;
+    std::uint32_t entryCount;
+
+    static std::uint16_t readU16(const std::uint8_t* bytes) noexcept {
+        return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    static std::uint32_t readU32(const std::uint8_t* bytes) noexcept {
+        return static_cast<std::uint32_t>(readU16(bytes)) | (static_cast<std::uint32_t>(readU16(bytes + 2)) << 16);
+    }
+
+    static std::uint64_t readU64(const std::uint8_t* bytes) noexcept {
+        return static_cast<std::uint64_t>(readU32(bytes)) | (static_cast<std::uint64_t>(readU32(bytes + 4)) << 32);
+    }
+};
+
+/**
+ * @class OpeningBookBuilder
+ * @brief Collects (position, move) statistics from games and writes an OpeningBook file
+ *
+ * Mọi ván phải cùng boardSize của builder (ván khác kích thước bị bỏ qua).
+ * Với mỗi ván, mỗi nước trong maxPly nước đầu được cộng trọng số vào vị trí ngay trước nó:
+ * nước của người thắng +2, ván hòa/chưa kết thúc +1 cho cả hai bên, nước của người thua
+ * không tính. Mỗi vị trí giữ nước có trọng số cao nhất (hòa thì ô có chỉ số nhỏ hơn).
+ */
+class OpeningBookBuilder {
+public:
+    static const int DEFAULT_MAX_PLY = 12;
+
+    explicit OpeningBookBuilder(int boardSize, int maxPly = DEFAULT_MAX_PLY)
+        : boardSize(boardSize), maxPly(std::max(1, maxPly)), gamesAdded(0), scratch(boardSize) {}
+
+    /**
+     * @return false nếu ván khác kích thước hoặc lịch sử không hợp lệ (phần hợp lệ phía trước vẫn được tính)
+     */
+    bool addGame(int size, const std::vector<std::tuple<int, int, int>>& moves, GameLogic::GameState result) {
+        if (size != boardSize || scratch.getSize() != boardSize) return false;
+        scratch.reset();
+
+        int winner = (result == GameLogic::GameState::PLAYER1_WIN) ? 1
+                   : (result == GameLogic::GameState::PLAYER2_WIN) ? 2 : 0;
+        int plies = std::min(maxPly, static_cast<int>(moves.size()));
+        for (int i = 0; i < plies; i++) {
+            auto [row, col, player] = moves[i];
+            if (scratch.getCell(row, col) != Board::EMPTY) return false;
+
+            int weight = (winner == 0) ? 1 : (player == winner ? 2 : 0);
+            if (weight > 0) addMove(scratch, row, col, player, weight);
+
+            if (!scratch.makeMove(row, col, player)) return false;
+        }
+
+        gamesAdded++;
+        return true;
+    }
+
+    bool addGame(const GameRecordReader::Game& game) {
+        std::vector<std::tuple<int, int, int>> moves;
+        int plies = std::min(maxPly, game.getMoveCount());
+        moves.reserve(plies);
+        for (int i = 0; i < plies; i++) {
+            moves.push_back(game.getMove(i));
+        }
+        return addGame(game.getBoardSize(), moves, game.getResult());
+    }
+
+    /**
+     * @return Số ván thêm được từ file record (ván khác kích thước không tính)
+     */
+    size_t addRecords(GameRecordReader& reader) {
+        size_t added = 0;
+        reader.forEach([&](const GameRecordReader::Game& game) {
+            if (addGame(game)) added++;
+        });
+        return added;
+    }
+
+    /**
+     * @brief Tự đánh games ván, mỗi ván bắt đầu bằng randomPlies nước ngẫu nhiên gần tâm
+     * (sinh từ seed) rồi hai engine luân phiên đi tới maxPly
+     * @tparam Engine Kiểu có findBestMove(BoardView) trả về nước có row/col (ví dụ AI)
+     */
+    template <typename Engine>
+    void addSelfPlay(Engine& first, Engine& second, int games, int randomPlies = 2, unsigned seed = 1) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> offset(-2, 2);
+
+        for (int g = 0; g < games; g++) {
+            Board board(boardSize);
+            int player = 1;
+            while (board.getMoveCount() < maxPly) {
+                int row, col;
+                if (board.getMoveCount() < randomPlies) {
+                    row = boardSize / 2 + offset(rng);
+                    col = boardSize / 2 + offset(rng);
+                    if (board.getCell(row, col) != Board::EMPTY) continue;
+                } else {
+                    auto move = (player == 1 ? first : second).findBestMove(board.getGrid());
+                    row = move.row;
+                    col = move.col;
+                }
+                if (!board.makeMove(row, col, player)) break;
+                if (board.hasFiveAt(row, col, player)) break;
+                player = 3 - player;
+            }
+            // Nước ngẫu nhiên đầu ván không phải lựa chọn của engine nên bỏ khỏi thống kê
+            addSelfPlayGame(board, randomPlies);
+        }
+    }
+
+    int getBoardSize() const noexcept { return boardSize; }
+    size_t getPositionCount() const noexcept { return positions.size(); }
+    size_t getGamesAdded() const noexcept { return gamesAdded; }
+
+    /**
+     * @brief Ghi file sách; chỉ giữ vị trí có trọng số nước tốt nhất >= minWeight
+     */
+    bool save(const std::string& path, int minWeight = 1) const {
+        std::vector<std::tuple<std::uint64_t, int, int>> entries;
+        for (const auto& [key, moves] : positions) {
+            int bestMove = OpeningBook::NO_MOVE, bestWeight = 0;
+            for (const auto& [move, weight] : moves) {
+                if (weight > bestWeight || (weight == bestWeight && move < bestMove)) {
+                    bestMove = move;
+                    bestWeight = weight;
+                }
+            }
+            if (key != 0 && bestWeight >= minWeight) {
+                entries.emplace_back(key, bestMove, std::min(bestWeight, 0xFFFF));
+            }
+        }
+
+        std::uint32_t slotCount = 16;
+        while (slotCount < 2 * entries.size()) slotCount *= 2;
+
+        std::vector<std::uint8_t> bytes(OpeningBook::HEADER_SIZE + static_cast<size_t>(slotCount) * OpeningBook::SLOT_SIZE, 0);
+        std::memcpy(bytes.data(), OpeningBook::MAGIC, sizeof(OpeningBook::MAGIC));
+        bytes[4] = OpeningBook::VERSION;
+        bytes[5] = static_cast<std::uint8_t>(boardSize);
+        writeLE(bytes.data() + 6, static_cast<std::uint64_t>(maxPly), 2);
+        writeLE(bytes.data() + 8, slotCount, 4);
+        writeLE(bytes.data() + 12, entries.size(), 4);
+
+        for (const auto& [key, move, weight] : entries) {
+            std::uint32_t i = static_cast<std::uint32_t>(key) & (slotCount - 1);
+            std::uint8_t* slot = bytes.data() + OpeningBook::HEADER_SIZE;
+            while (readKey(slot + static_cast<size_t>(i) * OpeningBook::SLOT_SIZE) != 0) {
+                i = (i + 1) & (slotCount - 1);
+            }
+            slot += static_cast<size_t>(i) * OpeningBook::SLOT_SIZE;
+            writeLE(slot, key, 8);
+            writeLE(slot + 8, static_cast<std::uint64_t>(move), 2);
+            writeLE(slot + 10, static_cast<std::uint64_t>(weight), 2);
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(out);
+    }
+
+private:
+    int boardSize;
+    int maxPly;
+    size_t gamesAdded;
+    Board scratch;
+    // Khóa chuẩn -> (nước trong hệ chuẩn -> trọng số)
+    std::unordered_map<std::uint64_t, std::unordered_map<int, int>> positions;
+
+    // Cộng weight cho nước (row, col) của player tại vị trí before, trong hệ tọa độ chuẩn
+    void addMove(const Board& before, int row, int col, int player, int weight) {
+        int symmetry;
+        std::uint64_t key = OpeningBook::canonicalKey(before, player, symmetry);
+        int r, c;
+        BoardSymmetry::apply(symmetry, before.getSize(), row, col, r, c);
+        positions[key][r * Board::MAX_SIZE + c] += weight;
+    }
+
+    // Ván tự đánh chưa có kết quả: cộng +1 cho mọi nước của engine
+    void addSelfPlayGame(const Board& board, int skipPlies) {
+        const auto& history = board.getMoveHistory();
+        Board replay(board.getSize());
+        for (size_t i = 0; i < history.size(); i++) {
+            auto [row, col, player] = history[i];
+            if (static_cast<int>(i) >= skipPlies) addMove(replay, row, col, player, 1);
+            replay.makeMove(row, col, player);
+        }
+        gamesAdded++;
+    }
+
+    static void writeLE(std::uint8_t* out, std::uint64_t value, int bytes) noexcept {
+        for (int i = 0; i < bytes; i++) {
+            out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+
+    static std::uint64_t readKey(const std::uint8_t* slot) noexcept {
+        return OpeningBook::readU64(slot);
+    }
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,175 @@
+// patterntable.cpp - Pattern Lookup Table
+// Người 1: Logic & AI - Bảng tra pattern theo cửa sổ 9 ô quanh một điểm
+#ifndef PATTERNTABLE_H
+#define PATTERNTABLE_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class PatternTable
+ * @brief Maps a 9-cell line window (center = player's stone) to a pattern code in one table load
+ *
+ * Cửa sổ gồm 2 mask 9 bit: own (quân của player) và blocked (quân đối thủ hoặc ngoài
+ * bàn cờ); bit WINDOW_RADIUS là ô giữa và luôn được coi là quân của player. 8 ô còn
+ * lại của hai mask được đổi sang chỉ số cơ số 3 qua bảng base3 rồi tra patterns.
+ *
+ * classify() là constexpr và được kiểm tra bằng static_assert; bản thân bảng quá lớn
+ * cho giới hạn constexpr của compiler nên được sinh một lần ở lần tra đầu tiên
+ * (giống Zobrist::table()).
+ *
+ * Pattern được định nghĩa theo số ô hoàn thành 5 (nên nhận ra cả dạng gãy X_XXX, XX_XX):
+ * - FIVE: có 5 quân liền qua ô giữa
+ * - FOUR_OPEN / FOUR_SEMI: >= 2 / đúng 1 ô trống mà đặt vào thành 5
+ * - THREE_OPEN / THREE_SEMI: đặt thêm một quân tạo được FOUR_OPEN / chỉ FOUR_SEMI
+ * - PAIR / SINGLE: có cửa sổ 5 ô không bị chặn chứa >= 2 / 1 quân
+ * - NONE: ô giữa không còn nằm trong cửa sổ 5 ô nào không bị chặn
+ */
+class PatternTable {
+public:
+    static const int WINDOW_RADIUS = 4;
+    static const int WINDOW_SIZE = 2 * WINDOW_RADIUS + 1;
+    static const int TABLE_SIZE = 6561;             // 3^8: ô giữa cố định, không cần mã hóa
+
+    // Cùng thứ tự với GameLogic::PatternType
+    enum Code : std::uint8_t {
+        NONE = 0,
+        SINGLE,
+        PAIR,
+        THREE_OPEN,
+        THREE_SEMI,
+        FOUR_OPEN,
+        FOUR_SEMI,
+        FIVE
+    };
+
+    static Code lookup(std::uint32_t own, std::uint32_t blocked) noexcept {
+        const Tables& t = tables();
+        std::uint32_t ownBits = dropCenter(own);
+        std::uint32_t blockedBits = dropCenter(blocked) & ~ownBits;
+        return static_cast<Code>(t.patterns[t.base3[ownBits] + 2 * t.base3[blockedBits]]);
+    }
+
+    /**
+     * @brief Phân loại trực tiếp, không qua bảng (dùng để sinh bảng và kiểm tra)
+     * @param cells 0 = trống, 1 = quân player, 2 = bị chặn; cells[WINDOW_RADIUS] phải là 1
+     */
+    static constexpr Code classify(std::array<std::uint8_t, WINDOW_SIZE> cells) {
+        if (maxStonesInOpenWindow(cells) == 5) return FIVE;
+
+        int completions = countCompletions(cells);
+        if (completions >= 2) return FOUR_OPEN;
+        if (completions == 1) return FOUR_SEMI;
+
+        bool semiThree = false;
+        for (int i = 0; i < WINDOW_SIZE; i++) {
+            if (cells[i] != 0) continue;
+            cells[i] = 1;
+            int next = countCompletions(cells);
+            cells[i] = 0;
+            if (next >= 2) return THREE_OPEN;
+            if (next == 1) semiThree = true;
+        }
+        if (semiThree) return THREE_SEMI;
+
+        int stones = maxStonesInOpenWindow(cells);
+        if (stones >= 2) return PAIR;
+        if (stones == 1) return SINGLE;
+        return NONE;
+    }
+
+private:
+    struct Tables {
+        std::array<std::uint16_t, 256> base3;
+        std::array<std::uint8_t, TABLE_SIZE> patterns;
+
+        Tables() : base3(makeBase3()), patterns(makePatterns()) {}
+    };
+
+    static const Tables& tables() {
+        static const Tables instance;
+        return instance;
+    }
+
+    // 9 bit -> 8 bit: bỏ bit ô giữa, dồn 4 bit phía trên xuống
+    static std::uint32_t dropCenter(std::uint32_t mask) noexcept {
+        return (mask & 0xF) | ((mask >> (WINDOW_RADIUS + 1)) & 0xF) << WINDOW_RADIUS;
+    }
+
+    /**
+     * @brief Số quân nhiều nhất trong một cửa sổ 5 ô chứa ô giữa mà không có ô bị chặn (-1 nếu không có)
+     */
+    static constexpr int maxStonesInOpenWindow(const std::array<std::uint8_t, WINDOW_SIZE>& cells) {
+        int best = -1;
+        for (int start = 0; start <= WINDOW_SIZE - 5; start++) {
+            int stones = 0;
+            bool open = true;
+            for (int i = start; i < start + 5; i++) {
+                if (cells[i] == 2) open = false;
+                if (cells[i] == 1) stones++;
+            }
+            if (open && stones > best) best = stones;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Số ô trống khác nhau mà đặt vào thành 5 quân liền qua ô giữa
+     */
+    static constexpr int countCompletions(const std::array<std::uint8_t, WINDOW_SIZE>& cells) {
+        bool completes[WINDOW_SIZE] = {};
+        for (int start = 0; start <= WINDOW_SIZE - 5; start++) {
+            int stones = 0, empties = 0, emptyAt = -1;
+            for (int i = start; i < start + 5; i++) {
+                if (cells[i] == 1) stones++;
+                else if (cells[i] == 0) { empties++; emptyAt = i; }
+            }
+            if (stones == 4 && empties == 1) completes[emptyAt] = true;
+        }
+
+        int count = 0;
+        for (bool complete : completes) count += complete ? 1 : 0;
+        return count;
+    }
+
+    static constexpr std::array<std::uint16_t, 256> makeBase3() {
+        std::array<std::uint16_t, 256> table = {};
+        for (int mask = 0; mask < 256; mask++) {
+            int value = 0, power = 1;
+            for (int i = 0; i < WINDOW_SIZE - 1; i++) {
+                if (mask & (1 << i)) value += power;
+                power *= 3;
+            }
+            table[mask] = static_cast<std::uint16_t>(value);
+        }
+        return table;
+    }
+
+    static constexpr std::array<std::uint8_t, TABLE_SIZE> makePatterns() {
+        std::array<std::uint8_t, TABLE_SIZE> table = {};
+        for (int index = 0; index < TABLE_SIZE; index++) {
+            std::array<std::uint8_t, WINDOW_SIZE> cells = {};
+            int rest = index;
+            for (int i = 0; i < WINDOW_SIZE; i++) {
+                if (i == WINDOW_RADIUS) {
+                    cells[i] = 1;
+                    continue;
+                }
+                cells[i] = static_cast<std::uint8_t>(rest % 3);
+                rest /= 3;
+            }
+            table[index] = classify(cells);
+        }
+        return table;
+    }
+};
+
+// Pattern gãy mà cách đếm quân liên tiếp cũ không thấy
+static_assert(PatternTable::classify({0, 0, 0, 1, 1, 0, 1, 1, 0}) == PatternTable::FOUR_SEMI, "XX_XX");
+static_assert(PatternTable::classify({0, 0, 1, 0, 1, 1, 1, 0, 0}) == PatternTable::FOUR_SEMI, "X_XXX");
+static_assert(PatternTable::classify({0, 0, 0, 1, 1, 1, 1, 0, 0}) == PatternTable::FOUR_OPEN, "_XXXX_");
+static_assert(PatternTable::classify({0, 0, 0, 1, 1, 0, 1, 0, 0}) == PatternTable::THREE_OPEN, "_XX_X_");
+static_assert(PatternTable::classify({0, 0, 2, 1, 1, 1, 0, 0, 0}) == PatternTable::THREE_SEMI, "OXXX__");
+static_assert(PatternTable::classify({2, 2, 2, 0, 1, 0, 2, 2, 2}) == PatternTable::NONE, "chặn cả hai phía");
+
+#endif // PATTERNTABLE_H
@@ -0,0 +1,242 @@
+// searchprofile.cpp - Search Profiling and Tracing
+// Người 1: Logic & AI - Đo thời gian từng pha, branching factor theo ply và xuất PV/cây search
+#ifndef SEARCHPROFILE_H
+#define SEARCHPROFILE_H
+
+#include <chrono>
+#include <ostream>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+
+#include "board.cpp"
+
+/**
+ * @class SearchProfile
+ * @brief Per-worker search counters; phase timers and per-ply counts exist only with -DCARO_SEARCH_PROFILE
+ *
+ * - iterationNodes: luôn bật (một phép ghi mỗi iteration), dùng để tính effective
+ *   branching factor = node iteration d / node iteration d-1
+ * - phase timers (sinh nước, sắp thứ tự, đánh giá, kiểm tra thắng) và số node/nước con
+ *   theo ply: chỉ khi bật macro; tắt macro thì các mảng này không tồn tại (ThinkingStats
+ *   được copy mỗi nước và BatchAnalyzer giữ một bản mỗi vị trí), Timer và record*() rỗng,
+ *   branchingFactor()/phaseSeconds() trả về 0
+ *
+ * Thời gian pha đo tại chỗ negamax gọi nên là inclusive: sinh nước gồm cả các phép
+ * kiểm tra thắng/chặn bên trong generateCandidateMoves.
+ */
+struct SearchProfile {
+#if defined(CARO_SEARCH_PROFILE)
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    enum Phase {
+        CANDIDATE_GENERATION,
+        MOVE_ORDERING,
+        EVALUATION,
+        WIN_CHECK,
+        PHASE_COUNT
+    };
+
+    static const int MAX_PLY = 64;
+
+#if defined(CARO_SEARCH_PROFILE)
+    long long phaseNanoseconds[PHASE_COUNT];
+    long long phaseCalls[PHASE_COUNT];
+    long long expandedAtPly[MAX_PLY];       // Node đã sinh nước ở mỗi ply
+    long long childrenAtPly[MAX_PLY];       // Nước con thực sự search (sau cắt tỉa) ở mỗi ply
+#endif
+    long long iterationNodes[MAX_PLY];      // Node của riêng iteration depth d (chỉ số = d)
+
+    SearchProfile() { clear(); }
+
+    void clear() {
+#if defined(CARO_SEARCH_PROFILE)
+        std::fill(std::begin(phaseNanoseconds), std::end(phaseNanoseconds), 0);
+        std::fill(std::begin(phaseCalls), std::end(phaseCalls), 0);
+        std::fill(std::begin(expandedAtPly), std::end(expandedAtPly), 0);
+        std::fill(std::begin(childrenAtPly), std::end(childrenAtPly), 0);
+#endif
+        std::fill(std::begin(iterationNodes), std::end(iterationNodes), 0);
+    }
+
+    /**
+     * @brief Cộng pha và số đếm theo ply; iterationNodes giữ nguyên vì mỗi worker bắt đầu ở depth khác nhau
+     */
+    void merge(const SearchProfile& other) {
+#if defined(CARO_SEARCH_PROFILE)
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            phaseNanoseconds[p] += other.phaseNanoseconds[p];
+            phaseCalls[p] += other.phaseCalls[p];
+        }
+        for (int ply = 0; ply < MAX_PLY; ply++) {
+            expandedAtPly[ply] += other.expandedAtPly[ply];
+            childrenAtPly[ply] += other.childrenAtPly[ply];
+        }
+#else
+        (void)other;
+#endif
+    }
+
+    void recordExpansion(int ply, long long children) {
+#if defined(CARO_SEARCH_PROFILE)
+        if (ply >= 0 && ply < MAX_PLY) {
+            expandedAtPly[ply]++;
+            childrenAtPly[ply] += children;
+        }
+#else
+        (void)ply;
+        (void)children;
+#endif
+    }
+
+    void recordIteration(int depth, long long nodes) {
+        if (depth >= 0 && depth < MAX_PLY) {
+            iterationNodes[depth] = nodes;
+        }
+    }
+
+    /**
+     * @brief Số nước con trung bình đã search ở ply (0 nếu không có dữ liệu)
+     */
+    double branchingFactor(int ply) const {
+#if defined(CARO_SEARCH_PROFILE)
+        if (ply < 0 || ply >= MAX_PLY || expandedAtPly[ply] == 0) return 0.0;
+        return static_cast<double>(childrenAtPly[ply]) / expandedAtPly[ply];
+#else
+        (void)ply;
+        return 0.0;
+#endif
+    }
+
+    /**
+     * @brief Tỉ lệ node giữa hai iteration hoàn thành cuối cùng; nếu chỉ có một iteration
+     *        (search theo depth cố định) thì dùng nodes^(1/depth)
+     */
+    double effectiveBranchingFactor() const {
+        for (int depth = MAX_PLY - 1; depth > 0; depth--) {
+            if (iterationNodes[depth] <= 0) continue;
+            if (iterationNodes[depth - 1] > 0) {
+                return static_cast<double>(iterationNodes[depth]) / iterationNodes[depth - 1];
+            }
+            return std::pow(static_cast<double>(iterationNodes[depth]), 1.0 / depth);
+        }
+        return 0.0;
+    }
+
+    double phaseSeconds(Phase phase) const {
+#if defined(CARO_SEARCH_PROFILE)
+        return phaseNanoseconds[phase] * 1e-9;
+#else
+        (void)phase;
+        return 0.0;
+#endif
+    }
+
+    static const char* phaseName(Phase phase) {
+        static const char* NAMES[PHASE_COUNT] = {"candidates", "ordering", "evaluation", "winCheck"};
+        return NAMES[phase];
+    }
+
+    /**
+     * @brief RAII timer cho một pha; không làm gì khi tắt CARO_SEARCH_PROFILE
+     */
+    class Timer {
+    public:
+#if defined(CARO_SEARCH_PROFILE)
+        Timer(SearchProfile& profile, Phase phase)
+            : profile(profile), phase(phase), start(std::chrono::steady_clock::now()) {}
+
+        ~Timer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            profile.phaseNanoseconds[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            profile.phaseCalls[phase]++;
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        SearchProfile& profile;
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+#else
+        Timer(SearchProfile&, Phase) {}
+#endif
+    };
+};
+
+/**
+ * @class SearchTraceSink
+ * @brief Receives the PV after every completed iteration and, with CARO_SEARCH_PROFILE, every searched edge
+ *
+ * Chỉ worker chính (thread 0) gửi trace, nên sink không bị gọi song song trong một
+ * search; với startSearch/startPondering sink được gọi từ thread nền.
+ * Nước đi mã hóa row * Board::MAX_SIZE + col như TranspositionTable.
+ */
+class SearchTraceSink {
+public:
+    struct Iteration {
+        int depth;
+        int score;
+        long long nodes;                    // Node tích lũy của worker chính
+        double seconds;                     // Tính từ lúc bắt đầu iterative deepening
+        const int* pv;                      // pvLength nước, bắt đầu từ nước gốc
+        int pvLength;
+    };
+
+    struct Node {
+        int ply;                            // Ply của nước vừa search (nước gốc = 0)
+        int move;
+        int player;
+        int alpha;                          // Cửa sổ trước khi search nước này
+        int beta;
+        int score;
+        bool cutoff;
+    };
+
+    virtual ~SearchTraceSink() {}
+    virtual void onIteration(const Iteration& iteration) = 0;
+    virtual void onNode(const Node&) {}
+};
+
+/**
+ * @class StreamTraceSink
+ * @brief Writes one JSON object per line (JSON Lines) to an ostream
+ *
+ * {"type":"iteration","depth":4,"score":120,"nodes":5120,"seconds":0.01,"pv":[[7,8],[8,8]]}
+ * {"type":"node","ply":1,"move":[8,8],"player":1,"alpha":-50,"beta":120,"score":30,"cutoff":false}
+ */
+class StreamTraceSink : public SearchTraceSink {
+public:
+    explicit StreamTraceSink(std::ostream& out, bool traceNodes = false)
+        : out(out), traceNodes(traceNodes) {}
+
+    void onIteration(const Iteration& iteration) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        out << "{\"type\":\"iteration\",\"depth\":" << iteration.depth << ",\"score\":" << iteration.score
+            << ",\"nodes\":" << iteration.nodes << ",\"seconds\":" << iteration.seconds << ",\"pv\":[";
+        for (int i = 0; i < iteration.pvLength; i++) {
+            out << (i ? "," : "") << '[' << iteration.pv[i] / Board::MAX_SIZE << ',' << iteration.pv[i] % Board::MAX_SIZE << ']';
+        }
+        out << "]}\n";
+    }
+
+    void onNode(const Node& node) override {
+        if (!traceNodes) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        out << "{\"type\":\"node\",\"ply\":" << node.ply << ",\"move\":[" << node.move / Board::MAX_SIZE << ','
+            << node.move % Board::MAX_SIZE << "],\"player\":" << node.player << ",\"alpha\":" << node.alpha
+            << ",\"beta\":" << node.beta << ",\"score\":" << node.score
+            << ",\"cutoff\":" << (node.cutoff ? "true" : "false") << "}\n";
+    }
+
+private:
+    std::ostream& out;
+    bool traceNodes;
+    std::mutex mutex;
+};
+
+#endif // SEARCHPROFILE_H
@@ -0,0 +1,478 @@
+// sparseboard.cpp - Sparse Tiled Board
+// Người 1: Logic & AI - Bàn cờ cực lớn lưu theo tile 16x16 cấp phát khi cần, bộ nhớ tỉ lệ với số quân đã đi
+#ifndef SPARSEBOARD_H
+#define SPARSEBOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <tuple>
+#include <algorithm>
+
+#include "board.cpp"
+
+/**
+ * @class SparseBoard
+ * @brief Board with the same move/query API as Board for sizes far beyond Board::MAX_SIZE
+ *
+ * Ô được gom thành tile TILE_SIZE x TILE_SIZE; tile chỉ được cấp phát khi có quân
+ * trong đó hoặc nằm trong bán kính ứng viên của một quân, và được tìm qua bảng băm
+ * open addressing (linear probing, load <= 1/2). Bộ nhớ vì vậy tỉ lệ với vùng đã chơi
+ * chứ không với size²; MAX_SIZE = 2^30 coi như bàn vô hạn.
+ *
+ * Khác Board:
+ * - Không có getGrid()/BoardView (không có grid dày). AI và GameLogic cần BoardView,
+ *   nên extractWindow() chép vùng đang chơi sang một Board thường để search
+ * - Không có bitboard: makesFive/hasFiveAt đếm quân dọc 4 hướng (tối đa 32 ô)
+ * - Hash dùng khóa splitmix64 của (row, col, player), không trùng với Zobrist của Board
+ * - Tile không bị giải phóng khi undo (tránh cấp phát lại liên tục trong search); reset() dọn hết
+ */
+class SparseBoard {
+public:
+    static const int TILE_SHIFT = 4;
+    static const int TILE_SIZE = 1 << TILE_SHIFT;          // 16
+    static const int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+    static const int MIN_SIZE = Board::MIN_SIZE;
+    static const int MAX_SIZE = 1 << 30;
+    static const int DEFAULT_SIZE = MAX_SIZE;
+    static const int CANDIDATE_RADIUS = Board::CANDIDATE_RADIUS;
+    static const int WIN_LENGTH = 5;
+
+    enum CellState {
+        EMPTY = Board::EMPTY,
+        PLAYER1 = Board::PLAYER1,
+        PLAYER2 = Board::PLAYER2
+    };
+
+    explicit SparseBoard(int boardSize = DEFAULT_SIZE)
+        : size(isValidSize(boardSize) ? boardSize : DEFAULT_SIZE), moveCount(0), hashKey(0) {
+        slots.assign(INITIAL_SLOTS, Slot());
+    }
+
+    // ================== BASIC OPERATIONS ==================
+
+    int getSize() const noexcept { return size; }
+    int getMoveCount() const noexcept { return moveCount; }
+    std::uint64_t getHashKey() const noexcept { return hashKey; }
+
+    static bool isValidSize(int boardSize) noexcept {
+        return boardSize >= MIN_SIZE && boardSize <= MAX_SIZE;
+    }
+
+    bool isInBounds(int row, int col) const noexcept {
+        return row >= 0 && row < size && col >= 0 && col < size;
+    }
+
+    /**
+     * @return Trạng thái ô, hoặc -1 nếu out of bounds (như Board::getCell)
+     */
+    int getCell(int row, int col) const noexcept {
+        if (!isInBounds(row, col)) return -1;
+        const Tile* tile = findTile(row, col);
+        return tile ? tile->cells[cellIndex(row, col)] : static_cast<int>(EMPTY);
+    }
+
+    bool isValidMove(int row, int col) const noexcept {
+        return getCell(row, col) == EMPTY;
+    }
+
+    bool makeMove(int row, int col, int player) {
+        if (!isValidMove(row, col) || (player != PLAYER1 && player != PLAYER2)) {
+            return false;
+        }
+
+        Tile& tile = tileFor(row, col);
+        const int cell = cellIndex(row, col);
+        tile.cells[cell] = static_cast<std::uint8_t>(player);
+        hashKey ^= pieceKey(row, col, player);
+        moveCount++;
+
+        moveHistory.emplace_back(row, col, player);
+        occupiedCells.emplace_back(row, col);
+        removeCandidate(tile, row, col);
+        updateNeighborCounts(row, col, +1);
+        return true;
+    }
+
+    bool undoLastMove() {
+        if (moveHistory.empty()) {
+            return false;
+        }
+
+        auto [row, col, player] = moveHistory.back();
+        Tile& tile = tileFor(row, col);
+        tile.cells[cellIndex(row, col)] = EMPTY;
+        hashKey ^= pieceKey(row, col, player);
+        moveCount--;
+
+        // Quân luôn được nhấc theo thứ tự ngược lúc đặt nên nằm cuối occupiedCells
+        moveHistory.pop_back();
+        occupiedCells.pop_back();
+        updateNeighborCounts(row, col, -1);
+        if (tileFor(row, col).neighborCounts[cellIndex(row, col)] > 0) {
+            addCandidate(tileFor(row, col), row, col);
+        }
+        return true;
+    }
+
+    bool undoMoves(int count) {
+        for (int i = 0; i < count; i++) {
+            if (!undoLastMove()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @return (row, col, player) của nước cuối, (-1, -1, -1) nếu bàn trống
+     */
+    std::tuple<int, int, int> getLastMove() const noexcept {
+        return moveHistory.empty() ? std::make_tuple(-1, -1, -1) : moveHistory.back();
+    }
+
+    const std::vector<std::tuple<int, int, int>>& getMoveHistory() const noexcept { return moveHistory; }
+    const std::vector<std::pair<int, int>>& getOccupiedCells() const noexcept { return occupiedCells; }
+
+    bool isFull() const noexcept {
+        return moveCount >= static_cast<long long>(size) * size;
+    }
+
+    bool isEmpty() const noexcept { return moveCount == 0; }
+
+    void reset() {
+        tiles.clear();
+        slots.assign(INITIAL_SLOTS, Slot());
+        moveHistory.clear();
+        occupiedCells.clear();
+        candidateCells.clear();
+        moveCount = 0;
+        hashKey = 0;
+    }
+
+    void reset(int newSize) {
+        if (isValidSize(newSize)) {
+            size = newSize;
+            reset();
+        }
+    }
+
+    // ================== WIN CHECKS ==================
+
+    /**
+     * @brief Có 5 quân liên tiếp của player đi qua (row, col) không
+     */
+    bool hasFiveAt(int row, int col, int player) const noexcept {
+        if (getCell(row, col) != player) return false;
+        for (const auto& [dr, dc] : DIRECTIONS) {
+            if (1 + countRun(row, col, dr, dc, player) + countRun(row, col, -dr, -dc, player) >= WIN_LENGTH) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Đặt quân player vào ô trống (row, col) có tạo thành 5 không (không sửa board)
+     */
+    bool makesFive(int row, int col, int player) const noexcept {
+        if (!isValidMove(row, col)) return false;
+        for (const auto& [dr, dc] : DIRECTIONS) {
+            if (1 + countRun(row, col, dr, dc, player) + countRun(row, col, -dr, -dc, player) >= WIN_LENGTH) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ================== AI SUPPORT ==================
+
+    /**
+     * @brief Ô trống có quân trong bán kính CANDIDATE_RADIUS; thứ tự không cố định (như Board)
+     */
+    const std::vector<std::pair<int, int>>& getCandidateCells() const noexcept { return candidateCells; }
+
+    bool isCandidateCell(int row, int col) const noexcept {
+        if (!isInBounds(row, col)) return false;
+        const Tile* tile = findTile(row, col);
+        return tile && tile->candidatePositions[cellIndex(row, col)] >= 0;
+    }
+
+    /**
+     * @return ((minRow, minCol), (maxRow, maxCol)) của các quân; tâm bàn nếu trống
+     */
+    std::pair<std::pair<int, int>, std::pair<int, int>> getActiveBounds() const {
+        if (occupiedCells.empty()) {
+            auto center = getBoardCenter();
+            return {center, center};
+        }
+
+        int minRow = size, maxRow = -1;
+        int minCol = size, maxCol = -1;
+        for (const auto& [row, col] : occupiedCells) {
+            minRow = std::min(minRow, row);
+            maxRow = std::max(maxRow, row);
+            minCol = std::min(minCol, col);
+            maxCol = std::max(maxCol, col);
+        }
+        return {{minRow, minCol}, {maxRow, maxCol}};
+    }
+
+    std::pair<int, int> getBoardCenter() const noexcept { return {size / 2, size / 2}; }
+
+    /**
+     * @brief Chép vùng đang chơi sang Board thường để AI/GameLogic dùng được BoardView
+     *
+     * Cửa sổ vuông bao các quân cộng thêm margin mỗi phía (tối thiểu Board::MIN_SIZE);
+     * lịch sử được đi lại đúng thứ tự nên lastMove và hash của window nhất quán.
+     * Ô (r, c) của window ứng với (originRow + r, originCol + c) trên SparseBoard.
+     * Biên window chặn đường như biên bàn thật, nên margin nên >= WIN_LENGTH.
+     *
+     * @return false nếu các quân trải rộng hơn Board::MAX_SIZE
+     */
+    bool extractWindow(Board& window, int& originRow, int& originCol, int margin = 8) const {
+        auto [minCell, maxCell] = getActiveBounds();
+        long long spanRows = static_cast<long long>(maxCell.first) - minCell.first + 1 + 2LL * margin;
+        long long spanCols = static_cast<long long>(maxCell.second) - minCell.second + 1 + 2LL * margin;
+        long long windowSize = std::max<long long>({spanRows, spanCols, Board::MIN_SIZE});
+        windowSize = std::min<long long>(windowSize, size);
+        if (windowSize > Board::MAX_SIZE) {
+            return false;
+        }
+
+        // Căn giữa cửa sổ quanh vùng quân rồi kẹp vào trong bàn
+        long long centerRow = (static_cast<long long>(minCell.first) + maxCell.first) / 2;
+        long long centerCol = (static_cast<long long>(minCell.second) + maxCell.second) / 2;
+        originRow = static_cast<int>(std::clamp<long long>(centerRow - windowSize / 2, 0, size - windowSize));
+        originCol = static_cast<int>(std::clamp<long long>(centerCol - windowSize / 2, 0, size - windowSize));
+
+        window.reset(static_cast<int>(windowSize));
+        if (window.getSize() != windowSize) {
+            return false;
+        }
+        for (const auto& [row, col, player] : moveHistory) {
+            if (!window.makeMove(row - originRow, col - originCol, player)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ================== STATISTICS ==================
+
+    double getOccupancyRate() const noexcept {
+        return static_cast<double>(moveCount) / (static_cast<double>(size) * size);
+    }
+
+    int getTileCount() const noexcept { return static_cast<int>(tiles.size()); }
+
+    size_t getMemoryUsage() const noexcept {
+        size_t usage = sizeof(*this);
+        usage += tiles.capacity() * sizeof(Tile);
+        usage += slots.capacity() * sizeof(Slot);
+        usage += moveHistory.capacity() * sizeof(std::tuple<int, int, int>);
+        usage += occupiedCells.capacity() * sizeof(std::pair<int, int>);
+        usage += candidateCells.capacity() * sizeof(std::pair<int, int>);
+        return usage;
+    }
+
+    /**
+     * @brief Kiểm tra số quân, hash, số đếm lân cận và tập ứng viên khớp với các tile
+     */
+    bool validateState() const noexcept {
+        int stones = 0;
+        size_t candidates = 0;
+        std::uint64_t actualHash = 0;
+
+        for (const Slot& slot : slots) {
+            if (slot.key == EMPTY_KEY) continue;
+            const Tile& tile = tiles[slot.tile];
+            int baseRow = static_cast<int>(slot.key >> 32) << TILE_SHIFT;
+            int baseCol = static_cast<int>(slot.key & 0xFFFFFFFFu) << TILE_SHIFT;
+
+            for (int cell = 0; cell < TILE_CELLS; cell++) {
+                int row = baseRow + (cell >> TILE_SHIFT);
+                int col = baseCol + (cell & (TILE_SIZE - 1));
+                if (!isInBounds(row, col)) continue;       // Phần tile của bàn lệch 16 nằm ngoài biên
+                if (tile.cells[cell] != EMPTY) {
+                    stones++;
+                    actualHash ^= pieceKey(row, col, tile.cells[cell]);
+                }
+                if (tile.neighborCounts[cell] != countNeighbors(row, col)) return false;
+
+                bool shouldBeCandidate = tile.cells[cell] == EMPTY && tile.neighborCounts[cell] > 0;
+                if (shouldBeCandidate != (tile.candidatePositions[cell] >= 0)) return false;
+                candidates += shouldBeCandidate;
+            }
+        }
+
+        return stones == moveCount && actualHash == hashKey &&
+               candidates == candidateCells.size() &&
+               occupiedCells.size() == static_cast<size_t>(moveCount) &&
+               moveHistory.size() == static_cast<size_t>(moveCount);
+    }
+
+private:
+    static const std::uint64_t EMPTY_KEY = ~0ULL;
+    static const size_t INITIAL_SLOTS = 64;
+    static constexpr std::pair<int, int> DIRECTIONS[4] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    struct Tile {
+        std::uint8_t cells[TILE_CELLS];
+        std::uint8_t neighborCounts[TILE_CELLS];    // Số quân trong bán kính CANDIDATE_RADIUS
+        std::int32_t candidatePositions[TILE_CELLS];// Vị trí trong candidateCells, -1 nếu không có
+
+        Tile() {
+            std::fill(std::begin(cells), std::end(cells), EMPTY);
+            std::fill(std::begin(neighborCounts), std::end(neighborCounts), 0);
+            std::fill(std::begin(candidatePositions), std::end(candidatePositions), -1);
+        }
+    };
+
+    struct Slot {
+        std::uint64_t key;                          // (tileRow << 32) | tileCol, EMPTY_KEY = trống
+        int tile;                                   // Chỉ số trong tiles
+
+        Slot() : key(EMPTY_KEY), tile(-1) {}
+    };
+
+    int size;
+    int moveCount;
+    std::uint64_t hashKey;
+    std::vector<Tile> tiles;                        // Chỉ số tile ổn định cho tới reset()
+    std::vector<Slot> slots;                        // Bảng băm tile, dung lượng là lũy thừa 2
+    std::vector<std::tuple<int, int, int>> moveHistory;
+    std::vector<std::pair<int, int>> occupiedCells;
+    std::vector<std::pair<int, int>> candidateCells;
+
+    static std::uint64_t tileKey(int row, int col) noexcept {
+        return (static_cast<std::uint64_t>(row >> TILE_SHIFT) << 32) |
+               static_cast<std::uint32_t>(col >> TILE_SHIFT);
+    }
+
+    static int cellIndex(int row, int col) noexcept {
+        return ((row & (TILE_SIZE - 1)) << TILE_SHIFT) | (col & (TILE_SIZE - 1));
+    }
+
+    static std::uint64_t mix(std::uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static std::uint64_t pieceKey(int row, int col, int player) noexcept {
+        std::uint64_t cell = (static_cast<std::uint64_t>(row) << 32) | static_cast<std::uint32_t>(col);
+        return mix(cell * 2 + static_cast<std::uint64_t>(player) + 0x9E3779B97F4A7C15ULL);
+    }
+
+    size_t slotFor(std::uint64_t key) const noexcept {
+        size_t mask = slots.size() - 1;
+        size_t i = static_cast<size_t>(mix(key)) & mask;
+        while (slots[i].key != EMPTY_KEY && slots[i].key != key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    const Tile* findTile(int row, int col) const noexcept {
+        const Slot& slot = slots[slotFor(tileKey(row, col))];
+        return slot.key == EMPTY_KEY ? nullptr : &tiles[slot.tile];
+    }
+
+    /**
+     * @brief Tile chứa (row, col), tạo mới nếu chưa có; tham chiếu cũ tới tile có thể mất hiệu lực
+     */
+    Tile& tileFor(int row, int col) {
+        std::uint64_t key = tileKey(row, col);
+        size_t i = slotFor(key);
+        if (slots[i].key == key) {
+            return tiles[slots[i].tile];
+        }
+
+        if ((tiles.size() + 1) * 2 > slots.size()) {
+            growSlots();
+            i = slotFor(key);
+        }
+        slots[i].key = key;
+        slots[i].tile = static_cast<int>(tiles.size());
+        tiles.emplace_back();
+        return tiles.back();
+    }
+
+    void growSlots() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.key != EMPTY_KEY) {
+                slots[slotFor(slot.key)] = slot;
+            }
+        }
+    }
+
+    int countRun(int row, int col, int dr, int dc, int player) const noexcept {
+        int count = 0;
+        for (int k = 1; k < WIN_LENGTH; k++) {
+            if (getCell(row + k * dr, col + k * dc) != player) break;
+            count++;
+        }
+        return count;
+    }
+
+    int countNeighbors(int row, int col) const noexcept {
+        int count = 0;
+        for (int r = row - CANDIDATE_RADIUS; r <= row + CANDIDATE_RADIUS; r++) {
+            for (int c = col - CANDIDATE_RADIUS; c <= col + CANDIDATE_RADIUS; c++) {
+                if ((r != row || c != col) && getCell(r, c) > EMPTY) count++;
+            }
+        }
+        return count;
+    }
+
+    void updateNeighborCounts(int row, int col, int delta) {
+        int startRow = std::max(0, row - CANDIDATE_RADIUS);
+        int endRow = std::min(size - 1, row + CANDIDATE_RADIUS);
+        int startCol = std::max(0, col - CANDIDATE_RADIUS);
+        int endCol = std::min(size - 1, col + CANDIDATE_RADIUS);
+
+        for (int r = startRow; r <= endRow; r++) {
+            for (int c = startCol; c <= endCol; c++) {
+                if (r == row && c == col) continue;
+
+                Tile& tile = tileFor(r, c);
+                const int cell = cellIndex(r, c);
+                std::uint8_t& count = tile.neighborCounts[cell];
+                count = static_cast<std::uint8_t>(count + delta);
+                if (tile.cells[cell] != EMPTY) continue;
+
+                if (delta > 0 && count == 1) {
+                    addCandidate(tile, r, c);
+                } else if (delta < 0 && count == 0) {
+                    removeCandidate(tile, r, c);
+                }
+            }
+        }
+    }
+
+    void addCandidate(Tile& tile, int row, int col) {
+        std::int32_t& position = tile.candidatePositions[cellIndex(row, col)];
+        if (position < 0) {
+            position = static_cast<std::int32_t>(candidateCells.size());
+            candidateCells.emplace_back(row, col);
+        }
+    }
+
+    void removeCandidate(Tile& tile, int row, int col) {
+        std::int32_t& position = tile.candidatePositions[cellIndex(row, col)];
+        if (position < 0) {
+            return;
+        }
+
+        // Swap-and-pop: đưa phần tử cuối vào chỗ trống
+        const std::pair<int, int> moved = candidateCells.back();
+        candidateCells[position] = moved;
+        tileFor(moved.first, moved.second).candidatePositions[cellIndex(moved.first, moved.second)] = position;
+        candidateCells.pop_back();
+        position = -1;
+    }
+};
+
+#endif // SPARSEBOARD_H
@@ -0,0 +1,36 @@
+// symmetry.cpp - Board Symmetries
+// Người 1: Logic & AI - 8 phép quay/lật của bàn vuông, dùng cho khóa chuẩn hóa và biến đổi nước đi
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <utility>
+
+/**
+ * @brief 8 phép đối xứng của bàn vuông: bit 2 = chuyển vị, rồi bit 0 = lật hàng, bit 1 = lật cột
+ *
+ * Board giữ khóa Zobrist của cả 8 ảnh (Board::getSymmetryKey) và khóa chuẩn = nhỏ nhất
+ * trong 8 khóa (Board::getCanonicalKey); nước đi trong hệ chuẩn đưa về bàn thật bằng
+ * apply(inverse(symmetry), ...).
+ */
+namespace BoardSymmetry {
+    static const int COUNT = 8;
+    static const int IDENTITY = 0;
+
+    inline void apply(int symmetry, int size, int row, int col, int& outRow, int& outCol) noexcept {
+        if (symmetry & 4) std::swap(row, col);
+        if (symmetry & 1) row = size - 1 - row;
+        if (symmetry & 2) col = size - 1 - col;
+        outRow = row;
+        outCol = col;
+    }
+
+    /**
+     * @brief Phép ngược: lật tự nghịch đảo; sau chuyển vị thì lật hàng/cột đổi vai trò cho nhau
+     */
+    inline int inverse(int symmetry) noexcept {
+        if (!(symmetry & 4)) return symmetry;
+        return 4 | ((symmetry & 1) << 1) | ((symmetry & 2) >> 1);
+    }
+}
+
+#endif // SYMMETRY_H
@@ -0,0 +1,410 @@
+// threatsearch.cpp - Threat-Space Search
+// Người 1: Logic & AI - Tìm hoặc bác bỏ thắng cưỡng bức (VCF/VCT) chỉ bằng nước tạo 4 và 3 mở
+#ifndef THREATSEARCH_H
+#define THREATSEARCH_H
+
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+
+#include "board.cpp"
+#include "gamelogic.cpp"
+
+/**
+ * @class ThreatSearch
+ * @brief Forcing-move search: attacker only plays fours (VCF) or fours and open threes (VCT)
+ *
+ * Nước tấn công được phân loại bằng GameLogic::getPattern (FOUR_OPEN, FOUR_SEMI,
+ * THREE_OPEN, kể cả dạng gãy). Nước phòng thủ được sinh đầy đủ để kết quả "thắng" luôn đúng:
+ * - Sau một nước 4: chặn ô hoàn thành 5 duy nhất (hoặc thua ngay nếu có >= 2 ô)
+ * - Sau một nước 3 mở: mọi ô trống trong phạm vi 5 ô trên đường của nước 3,
+ *   cộng mọi nước phản công tạo 4 của bên phòng thủ
+ * Bên phòng thủ có sẵn ô tạo 5 thì nhánh đó bị bác bỏ.
+ *
+ * Vị trí đã bác bỏ được cache theo Zobrist hash trong một lần solve().
+ */
+class ThreatSearch {
+public:
+    struct Limits {
+        int maxDepth;                       // Số nước tấn công tối đa
+        bool allowThrees;                   // false = VCF, true = VCT
+        std::chrono::milliseconds timeLimit;
+
+        Limits(int depth = 8, bool threes = false,
+               std::chrono::milliseconds time = std::chrono::milliseconds(100))
+            : maxDepth(depth), allowThrees(threes), timeLimit(time) {}
+    };
+
+    struct Stats {
+        int nodesSearched;
+        int positionsSolved;                // Vị trí tấn công chứng minh được thắng
+        int positionsRefuted;               // Vị trí chứng minh không thắng trong giới hạn depth
+        int maxDepthReached;
+        bool timedOut;
+        double timeElapsed;
+
+        Stats() : nodesSearched(0), positionsSolved(0), positionsRefuted(0),
+                  maxDepthReached(0), timedOut(false), timeElapsed(0.0) {}
+    };
+
+    struct Result {
+        bool found;
+        int row;
+        int col;
+        int depth;                          // Số nước tấn công của chuỗi thắng tìm được
+
+        Result() : found(false), row(-1), col(-1), depth(0) {}
+    };
+
+    /**
+     * @brief Tìm chuỗi thắng cưỡng bức cho attacker, attacker đi trước
+     * @param board Vị trí hiện tại; được make/unmake trong lúc search và trả về nguyên trạng
+     * @param deadline Hạn chót tuyệt đối, kết hợp với limits.timeLimit (lấy cái sớm hơn)
+     * @param stop Cờ dừng từ bên ngoài (nullptr = không có), đọc cùng lúc với đồng hồ
+     * @param cancel Cờ dừng thứ hai, vd. cờ hủy riêng của AI bên cạnh token của caller (nullptr = không có)
+     */
+    Result solve(Board& board, int attacker, const Limits& limits,
+                 std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                 const std::atomic<bool>* stop = nullptr, const std::atomic<bool>* cancel = nullptr) {
+        auto startTime = std::chrono::steady_clock::now();
+        stats = Stats();
+        refuted.clear();
+        this->attacker = attacker;
+        defender = (attacker == 1) ? 2 : 1;
+        allowThrees = limits.allowThrees;
+        maxDepth = limits.maxDepth;
+        this->deadline = std::min(deadline, startTime + limits.timeLimit);
+        this->stop = stop;
+        this->cancel = cancel;
+        aborted = false;
+
+        Result result;
+        int row = -1, col = -1;
+        for (int depth = 1; depth <= maxDepth && !aborted; depth++) {
+            iterationDepth = depth;
+            if (attack(board, depth, -1, -1, &row, &col)) {
+                result.found = true;
+                result.row = row;
+                result.col = col;
+                result.depth = depth;
+                break;
+            }
+        }
+
+        stats.timedOut = aborted;
+        stats.timeElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    static const int DIRECTION_COUNT = LineBitboards::DIRECTION_COUNT;
+    static const int DEFENSE_RANGE = 5;      // Ô phòng thủ tối đa cách nước 3 bao xa
+
+    enum Threat {
+        THREAT_NONE = 0,
+        THREAT_THREE = 1,
+        THREAT_FOUR = 2,
+        THREAT_FIVE = 3
+    };
+
+    struct Move {
+        int row;
+        int col;
+        int threat;
+    };
+
+    int attacker = 1;
+    int defender = 2;
+    bool allowThrees = false;
+    int maxDepth = 0;
+    int iterationDepth = 0;
+    bool aborted = false;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* stop = nullptr;
+    const std::atomic<bool>* cancel = nullptr;
+    Stats stats;
+    std::unordered_map<std::uint64_t, int> refuted;   // key -> depth đã bác bỏ
+
+    // Cùng thứ tự với LineBitboards::Direction
+    static constexpr int DIRECTIONS[DIRECTION_COUNT][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    // Gọi sau khi đếm node: đọc cờ và đồng hồ ở node đầu tiên rồi mỗi 256 node,
+    // nên cờ đã bật hay deadline đã qua dừng được cả lần solve rất nhỏ
+    bool checkTime() {
+        if (!aborted && ((stats.nodesSearched - 1) & 255) == 0 &&
+            ((stop && stop->load(std::memory_order_relaxed)) || (cancel && cancel->load(std::memory_order_relaxed)) ||
+             std::chrono::steady_clock::now() >= deadline)) {
+            aborted = true;
+        }
+        return aborted;
+    }
+
+    /**
+     * @brief Lượt attacker; (pendingRow, pendingCol) là nước đe dọa trước đó còn hiệu lực
+     */
+    bool attack(Board& board, int depth, int pendingRow, int pendingCol, int* outRow = nullptr, int* outCol = nullptr) {
+        stats.nodesSearched++;
+        stats.maxDepthReached = std::max(stats.maxDepthReached, iterationDepth - depth + 1);
+        if (checkTime()) return false;
+
+        Move five[2];
+        if (collectFiveCells(board, attacker, five) > 0) {
+            if (outRow) { *outRow = five[0].row; *outCol = five[0].col; }
+            return true;
+        }
+        if (depth <= 0) return false;
+
+        std::uint64_t key = board.getHashKey();
+        if (pendingRow >= 0) {
+            // Ô đe dọa đang chờ chứa quân attacker, nên khóa của defender tại đó không trùng với quân thật
+            key ^= Zobrist::piece(pendingRow, pendingCol, defender) ^ Zobrist::sideKey();
+        }
+        auto cached = refuted.find(key);
+        if (cached != refuted.end() && cached->second >= depth) {
+            return false;
+        }
+
+        bool win = false;
+        int forced = collectFiveCells(board, defender, five);
+        if (forced >= 2) {
+            win = false;
+        } else if (forced == 1) {
+            // Bên phòng thủ phản công bằng nước 4: buộc phải chặn
+            const Move& block = five[0];
+            board.makeMove(block.row, block.col, attacker);
+            int threat = classify(board, block.row, block.col);
+            if (threat >= minimumThreat()) {
+                win = defend(board, depth - 1, block.row, block.col);
+            } else if (pendingRow >= 0) {
+                win = defend(board, depth - 1, pendingRow, pendingCol);
+            }
+            board.undoLastMove();
+            if (win && outRow) { *outRow = block.row; *outCol = block.col; }
+        } else {
+            std::vector<Move> moves = generateThreats(board);
+            for (const Move& move : moves) {
+                board.makeMove(move.row, move.col, attacker);
+                win = defend(board, depth - 1, move.row, move.col);
+                board.undoLastMove();
+                if (aborted) return false;
+                if (win) {
+                    if (outRow) { *outRow = move.row; *outCol = move.col; }
+                    break;
+                }
+            }
+        }
+
+        if (aborted) return false;
+        if (win) {
+            stats.positionsSolved++;
+        } else {
+            stats.positionsRefuted++;
+            refuted[key] = depth;
+        }
+        return win;
+    }
+
+    /**
+     * @brief Lượt defender, ngay sau nước đe dọa của attacker tại (row, col)
+     * @return true nếu mọi nước phòng thủ đều thua
+     */
+    bool defend(Board& board, int depth, int row, int col) {
+        stats.nodesSearched++;
+        if (checkTime()) return false;
+
+        Move five[2];
+        if (collectFiveCells(board, defender, five) > 0) {
+            return false;
+        }
+
+        int attackerFives = collectFiveCells(board, attacker, five);
+        if (attackerFives >= 2) {
+            return true;
+        }
+        if (attackerFives == 1) {
+            board.makeMove(five[0].row, five[0].col, defender);
+            bool win = attack(board, depth, row, col);
+            board.undoLastMove();
+            return win;
+        }
+
+        std::vector<Move> defenses;
+        if (!collectThreeDefenses(board, row, col, defenses)) {
+            return false;                    // Không có nước 3 thật nào để ép
+        }
+        collectCounterFours(board, defenses);
+
+        for (const Move& move : defenses) {
+            board.makeMove(move.row, move.col, defender);
+            bool win = attack(board, depth, row, col);
+            board.undoLastMove();
+            if (!win || aborted) return false;
+        }
+        return true;
+    }
+
+    int minimumThreat() const noexcept {
+        return allowThrees ? THREAT_THREE : THREAT_FOUR;
+    }
+
+    /**
+     * @brief Mức đe dọa của quân attacker tại (row, col) theo GameLogic::PatternType
+     * Ô trống được coi như attacker vừa đặt quân vào, nên không cần make/unmake để thử.
+     */
+    int classify(const Board& board, int row, int col, unsigned* threeDirections = nullptr) const {
+        int best = THREAT_NONE;
+        if (threeDirections) *threeDirections = 0;
+
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            GameLogic::PatternType pattern = GameLogic::getPattern(board, row, col,
+                                                                   DIRECTIONS[d][0], DIRECTIONS[d][1], attacker);
+            int threat = THREAT_NONE;
+            if (pattern == GameLogic::PatternType::FIVE) {
+                threat = THREAT_FIVE;
+            } else if (pattern == GameLogic::PatternType::FOUR_OPEN || pattern == GameLogic::PatternType::FOUR_SEMI) {
+                threat = THREAT_FOUR;
+            } else if (pattern == GameLogic::PatternType::THREE_OPEN) {
+                threat = THREAT_THREE;
+                if (threeDirections) *threeDirections |= 1u << d;
+            }
+            best = std::max(best, threat);
+        }
+        return best;
+    }
+
+    /**
+     * @brief Tối đa 2 ô trống mà player đặt vào là thành 5 (ô đó luôn kề một quân nên nằm trong tập ứng viên)
+     */
+    int collectFiveCells(const Board& board, int player, Move (&out)[2]) const {
+        int count = 0;
+        for (const auto& [r, c] : board.getCandidateCells()) {
+            if (board.makesFive(r, c, player)) {
+                out[count++] = Move{r, c, THREAT_FIVE};
+                if (count == 2) break;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Nước tạo 4 (và 3 mở nếu VCT) của attacker; nước 4 xếp trước
+     * Nước tạo 4 hay 3 luôn có một quân cùng màu trong bán kính 2, tức nằm trong tập ứng viên.
+     */
+    std::vector<Move> generateThreats(const Board& board) {
+        std::vector<Move> threats;
+        const LineBitboards& masks = board.getLineMasks();
+        int minimumStones = allowThrees ? 2 : 3;
+
+        for (const auto& [r, c] : board.getCandidateCells()) {
+            bool promising = false;
+            for (int d = 0; d < DIRECTION_COUNT && !promising; d++) {
+                promising = static_cast<int>(std::bitset<9>(masks.window(r, c, d, attacker)).count()) >= minimumStones;
+            }
+            if (!promising) continue;
+
+            int threat = classify(board, r, c);
+            if (threat >= minimumThreat()) {
+                threats.push_back(Move{r, c, threat});
+            }
+        }
+
+        // Thứ tự tập ứng viên phụ thuộc lịch sử make/unmake; sắp toàn phần để kết quả ổn định
+        std::sort(threats.begin(), threats.end(), [](const Move& a, const Move& b) {
+            if (a.threat != b.threat) return a.threat > b.threat;
+            return a.row != b.row ? a.row < b.row : a.col < b.col;
+        });
+        return threats;
+    }
+
+    /**
+     * @brief Ô phòng thủ quanh nước 3 mở tại (row, col)
+     * Chỉ tính hướng mà attacker thật sự có nước tiếp theo tạo được 2 ô thành 5;
+     * mọi ô liên quan đến nước đó nằm trong DEFENSE_RANGE trên cùng đường.
+     * @return false nếu không có nước 3 nào là đe dọa thật
+     */
+    bool collectThreeDefenses(Board& board, int row, int col, std::vector<Move>& defenses) {
+        unsigned threeDirections = 0;
+        classify(board, row, col, &threeDirections);
+        bool anyReal = false;
+
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            if (!(threeDirections & (1u << d))) continue;
+            int dr = DIRECTIONS[d][0], dc = DIRECTIONS[d][1];
+
+            bool real = false;
+            for (int k = -LineBitboards::WINDOW_RADIUS; k <= LineBitboards::WINDOW_RADIUS && !real; k++) {
+                int er = row + k * dr, ec = col + k * dc;
+                if (k == 0 || !board.isValidMove(er, ec)) continue;
+                board.makeMove(er, ec, attacker);
+                real = countFiveCellsOnLine(board, row, col, dr, dc) >= 2;
+                board.undoLastMove();
+            }
+            if (!real) continue;
+            anyReal = true;
+
+            for (int k = -DEFENSE_RANGE; k <= DEFENSE_RANGE; k++) {
+                int nr = row + k * dr, nc = col + k * dc;
+                if (k != 0 && board.isValidMove(nr, nc)) {
+                    addUnique(defenses, Move{nr, nc, THREAT_NONE});
+                }
+            }
+        }
+        return anyReal;
+    }
+
+    int countFiveCellsOnLine(const Board& board, int row, int col, int dr, int dc) const {
+        int count = 0;
+        for (int k = -DEFENSE_RANGE; k <= DEFENSE_RANGE; k++) {
+            int nr = row + k * dr, nc = col + k * dc;
+            if (board.isValidMove(nr, nc) && board.makesFive(nr, nc, attacker)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Nước phản công tạo 4 của defender (kể cả 4 gãy), dùng bitboard nên chính xác
+     */
+    void collectCounterFours(Board& board, std::vector<Move>& defenses) {
+        const LineBitboards& masks = board.getLineMasks();
+        std::vector<Move> candidates;
+
+        for (const auto& [r, c] : board.getCandidateCells()) {
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                if (std::bitset<9>(masks.window(r, c, d, defender)).count() >= 3) {
+                    candidates.push_back(Move{r, c, THREAT_NONE});
+                    break;
+                }
+            }
+        }
+
+        for (const Move& move : candidates) {
+            board.makeMove(move.row, move.col, defender);
+            bool four = false;
+            for (int d = 0; d < DIRECTION_COUNT && !four; d++) {
+                int dr = DIRECTIONS[d][0], dc = DIRECTIONS[d][1];
+                for (int k = -LineBitboards::WINDOW_RADIUS; k <= LineBitboards::WINDOW_RADIUS && !four; k++) {
+                    int nr = move.row + k * dr, nc = move.col + k * dc;
+                    four = k != 0 && board.isValidMove(nr, nc) && board.makesFive(nr, nc, defender);
+                }
+            }
+            board.undoLastMove();
+            if (four) addUnique(defenses, move);
+        }
+    }
+
+    static void addUnique(std::vector<Move>& moves, const Move& move) {
+        for (const Move& existing : moves) {
+            if (existing.row == move.row && existing.col == move.col) return;
+        }
+        moves.push_back(move);
+    }
+};
+
+#endif // THREATSEARCH_H
@@ -0,0 +1,500 @@
+// tournament.cpp - Self-Play Tournament
+// Người 1: Logic & AI - Hai cấu hình engine đấu N ván song song, cố định seed, báo tỉ lệ thắng kèm khoảng tin cậy
+//
+// Build: g++ -std=c++17 -O2 -pthread tournament.cpp -o caro_tournament
+// Usage: caro_tournament [--games N] [--workers N] [--size S] [--seed S] [--opening-plies N]
+//                        [--max-moves N] [--records FILE] [--a ENGINE] [--b ENGINE]
+//        ENGINE = danh sách key=value cách nhau bởi dấu phẩy, vd. difficulty=6,style=aggressive,ms=200
+//                 (name, difficulty, style, candidates, depth, ms, hash-mb, book)
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+
+#include "board.cpp"
+#include "gamelogic.cpp"
+#include "ai.cpp"
+#include "gamerecord.cpp"
+
+/**
+ * @class Tournament
+ * @brief Plays paired self-play games between two engine configurations on a worker pool
+ *
+ * - Ván được đánh theo cặp: ván 2k và 2k+1 dùng cùng khai cuộc ngẫu nhiên, hai engine đổi
+ *   màu, nên lợi thế đi trước và khai cuộc lệch triệt tiêu trong từng cặp
+ * - Khai cuộc sinh bằng mt19937 seed theo (seed, k) và chỉ dùng raw output, như Benchmark;
+ *   AI của mỗi ván được setSeed theo chỉ số ván và table được xóa trước mỗi ván, nên kết quả
+ *   không phụ thuộc worker nào đánh ván nào. Với ms = 0 (search theo depth) cùng seed cho
+ *   cùng các ván, trừ khi threat search chạm giới hạn thời gian của nó
+ * - Mỗi worker giữ một table và hai AI (người 1 / người 2) cho mỗi engine; hai AI cùng
+ *   engine dùng chung table vì cùng PlayStyle
+ * - Ván được ghi ra file record theo thứ tự chỉ số sau khi cả giải xong, nên file cũng
+ *   tất định; kết quả ván ghi bằng GameState như GameRecordWriter
+ * - Nước không hợp lệ hoặc engine không trả về nước nào tính là thua (forfeit)
+ */
+class Tournament {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int ENGINE_COUNT = 2;
+    static const int OPENING_WINDOW = 5;            // Khai cuộc trong cửa sổ 5x5 quanh tâm
+    static const int MAX_OPENING_PLIES = 12;
+    static constexpr double CONFIDENCE_Z = 1.96;    // Khoảng tin cậy 95%, xấp xỉ chuẩn
+
+    struct Engine {
+        std::string name;
+        AI::Difficulty difficulty;
+        AI::PlayStyle playStyle;
+        int maxCandidates;                      // 0 = theo difficulty
+        int depthLimit;                         // 0 = theo difficulty (chỉ hạ được)
+        std::chrono::milliseconds moveTime;     // 0 = search theo depth
+        size_t hashMegabytes;
+        std::string bookPath;                   // Sách khai cuộc (rỗng = không dùng)
+
+        explicit Engine(const std::string& name = "") : name(name), difficulty(AI::Difficulty::MEDIUM),
+                        playStyle(AI::PlayStyle::BALANCED), maxCandidates(0), depthLimit(0), moveTime(0),
+                        hashMegabytes(TranspositionTable::DEFAULT_SIZE_MB) {}
+    };
+
+    struct Options {
+        Engine engines[ENGINE_COUNT];
+        int games;                              // Làm tròn lên số chẵn
+        int workerCount;                        // 0 = std::thread::hardware_concurrency()
+        int boardSize;
+        int openingPlies;                       // Quân ngẫu nhiên trước khi engine bắt đầu đi
+        int maxMoves;                           // Tổng số nước tối đa rồi xử hòa; 0 = tới khi kín bàn
+        std::uint32_t seed;
+        std::string recordPath;                 // Rỗng = không ghi
+
+        Options() : engines{Engine("A"), Engine("B")}, games(20), workerCount(0), boardSize(15),
+                    openingPlies(2), maxMoves(0), seed(20240601u) {}
+    };
+
+    struct EngineResult {
+        int wins;
+        int losses;
+        int draws;
+        int forfeits;                           // Số ván thua vì nước không hợp lệ
+        int winsAsFirst;                        // Thắng khi cầm quân người 1
+        long long moves;
+        long long nodes;
+        double seconds;                         // Tổng thời gian nghĩ
+
+        EngineResult() : wins(0), losses(0), draws(0), forfeits(0), winsAsFirst(0), moves(0),
+                         nodes(0), seconds(0.0) {}
+
+        int games() const { return wins + losses + draws; }
+        double score() const { return games() > 0 ? (wins + 0.5 * draws) / games() : 0.0; }
+
+        /**
+         * @brief Nửa độ rộng khoảng tin cậy của score, từ phương sai mẫu của kết quả từng ván
+         */
+        double scoreMargin() const {
+            int n = games();
+            if (n < 2) return 0.0;
+            double s = score();
+            double variance = (wins * (1.0 - s) * (1.0 - s) + draws * (0.5 - s) * (0.5 - s) +
+                               losses * s * s) / (n - 1);
+            return CONFIDENCE_Z * std::sqrt(variance / n);
+        }
+
+        double averageMoveMs() const { return moves > 0 ? 1000.0 * seconds / moves : 0.0; }
+        double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+    };
+
+    explicit Tournament(const Options& options) : options(options), totalSeconds(0.0), workerCount(0) {}
+
+    /**
+     * @brief Mở sách của từng engine (gọi trước run()); false nếu có sách không mở được
+     */
+    bool loadBooks(std::string& failedPath) {
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            const std::string& path = options.engines[e].bookPath;
+            books[e] = path.empty() ? nullptr : OpeningBook::load(path);
+            if (!path.empty() && !books[e]) {
+                failedPath = path;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @return false nếu không mở hoặc ghi được file record
+     */
+    bool run() {
+        int count = (options.games + 1) / 2 * 2;
+        games.assign(count, Game());
+        std::atomic<int> next(0);
+
+        int workers = options.workerCount > 0 ? options.workerCount
+                                              : static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(1, std::min(workers, count));
+
+        auto start = Clock::now();
+        std::vector<std::thread> pool;
+        for (int i = 0; i < workers; i++) {
+            pool.emplace_back([this, &next, count]() { runWorker(next, count); });
+        }
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        workerCount = workers;
+
+        tally();
+        return writeRecords();
+    }
+
+    const EngineResult& getResult(int engine) const { return results[engine]; }
+
+    void report(std::ostream& out) const {
+        const EngineResult& a = results[0];
+        out << "games " << games.size() << ", board " << options.boardSize << ", seed " << options.seed
+            << ", workers " << workerCount << ", " << std::fixed << std::setprecision(1) << totalSeconds << " s\n";
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            const Engine& engine = options.engines[e];
+            const EngineResult& r = results[e];
+            double margin = r.scoreMargin();
+            out << engine.name << " (" << describe(engine) << ")\n"
+                << "  +" << r.wins << " -" << r.losses << " =" << r.draws
+                << "  (" << r.winsAsFirst << " wins as first player, " << r.forfeits << " forfeits)\n"
+                << std::setprecision(3)
+                << "  score " << r.score() << " +/- " << margin << " (95%)"
+                << std::showpos << std::setprecision(0)
+                << "  elo " << elo(r.score()) << " [" << elo(r.score() - margin) << ", "
+                << elo(r.score() + margin) << "]" << std::noshowpos << "\n"
+                << std::setprecision(2)
+                << "  " << r.moves << " moves, " << r.averageMoveMs() << " ms/move, "
+                << std::setprecision(0) << r.nodesPerSecond() << " nps\n";
+        }
+        out << "draw rate " << std::setprecision(3)
+            << (games.empty() ? 0.0 : static_cast<double>(a.draws) / games.size()) << "\n";
+        out.unsetf(std::ios::floatfield);
+    }
+
+    /**
+     * @brief Đọc tham số dòng lệnh; false nếu tham số sai
+     */
+    static bool parseArguments(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+
+            if (arg == "--games") {
+                options.games = std::atoi(value.c_str());
+                if (options.games <= 0) return false;
+            } else if (arg == "--workers") {
+                options.workerCount = std::atoi(value.c_str());
+                if (options.workerCount < 0) return false;
+            } else if (arg == "--size") {
+                options.boardSize = std::atoi(value.c_str());
+                if (options.boardSize < Board::MIN_SIZE || options.boardSize > Board::MAX_SIZE) return false;
+            } else if (arg == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            } else if (arg == "--opening-plies") {
+                options.openingPlies = std::atoi(value.c_str());
+                if (options.openingPlies < 0 || options.openingPlies > MAX_OPENING_PLIES) return false;
+            } else if (arg == "--max-moves") {
+                options.maxMoves = std::atoi(value.c_str());
+                if (options.maxMoves < 0 || options.maxMoves > GameRecord::MAX_MOVES) return false;
+            } else if (arg == "--records") {
+                options.recordPath = value;
+            } else if (arg == "--a") {
+                if (!parseEngine(value, options.engines[0])) return false;
+            } else if (arg == "--b") {
+                if (!parseEngine(value, options.engines[1])) return false;
+            } else {
+                return false;
+            }
+        }
+        return options.boardSize >= OPENING_WINDOW;
+    }
+
+    /**
+     * @brief Đọc "key=value,key=value"; key không có trong danh sách hoặc giá trị sai trả về false
+     */
+    static bool parseEngine(const std::string& spec, Engine& engine) {
+        std::istringstream fields(spec);
+        std::string field;
+        while (std::getline(fields, field, ',')) {
+            size_t equals = field.find('=');
+            if (equals == std::string::npos) return false;
+            std::string key = field.substr(0, equals);
+            std::string value = field.substr(equals + 1);
+            int number = std::atoi(value.c_str());
+
+            if (key == "name") {
+                if (value.empty()) return false;
+                engine.name = value;
+            } else if (key == "difficulty") {
+                if (!parseDifficulty(value, engine.difficulty)) return false;
+            } else if (key == "style") {
+                if (!parseStyle(value, engine.playStyle)) return false;
+            } else if (key == "candidates") {
+                if (number < 0) return false;
+                engine.maxCandidates = number;
+            } else if (key == "depth") {
+                if (number < 0) return false;
+                engine.depthLimit = number;
+            } else if (key == "ms") {
+                if (number < 0) return false;
+                engine.moveTime = std::chrono::milliseconds(number);
+            } else if (key == "book") {
+                engine.bookPath = value;
+            } else if (key == "hash-mb") {
+                if (number <= 0) return false;
+                engine.hashMegabytes = static_cast<size_t>(number);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Game {
+        std::vector<std::tuple<int, int, int>> moves;
+        GameLogic::GameState result;
+        int firstEngine;                        // Engine cầm quân người 1
+        int forfeitEngine;                      // -1 = không có forfeit
+        long long moveCounts[ENGINE_COUNT];
+        long long nodes[ENGINE_COUNT];
+        double seconds[ENGINE_COUNT];
+
+        Game() : result(GameLogic::GameState::PLAYING), firstEngine(0), forfeitEngine(-1),
+                 moveCounts{0, 0}, nodes{0, 0}, seconds{0.0, 0.0} {}
+    };
+
+    /**
+     * @brief AI của một engine trên một worker: players[p - 1] cầm quân người p, chung một table
+     */
+    struct Seat {
+        std::shared_ptr<TranspositionTable> table;
+        std::unique_ptr<AI> players[2];
+    };
+
+    Options options;
+    std::vector<Game> games;
+    EngineResult results[ENGINE_COUNT];
+    std::shared_ptr<const OpeningBook> books[ENGINE_COUNT];     // Dùng chung cho mọi worker
+    double totalSeconds;
+    int workerCount;
+    std::mutex progressMutex;
+
+    void runWorker(std::atomic<int>& next, int count) {
+        Seat seats[ENGINE_COUNT];
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            const Engine& engine = options.engines[e];
+            seats[e].table = std::make_shared<TranspositionTable>(engine.hashMegabytes);
+            for (int p = 1; p <= 2; p++) {
+                auto ai = std::make_unique<AI>(p, engine.difficulty, engine.playStyle, seats[e].table);
+                ai->setOpeningBook(books[e]);
+                if (engine.maxCandidates > 0) ai->setMaxCandidates(engine.maxCandidates);
+                seats[e].players[p - 1] = std::move(ai);
+            }
+        }
+
+        for (int index = next++; index < count; index = next++) {
+            playGame(index, seats);
+
+            const Game& game = games[index];
+            std::lock_guard<std::mutex> lock(progressMutex);
+            std::cerr << "game " << (index + 1) << "/" << count << ": "
+                      << options.engines[game.firstEngine].name << " vs "
+                      << options.engines[1 - game.firstEngine].name << " "
+                      << GameLogic::gameStateToString(game.result) << " in " << game.moves.size()
+                      << " moves" << std::endl;
+        }
+    }
+
+    void playGame(int index, Seat (&seats)[ENGINE_COUNT]) {
+        Game& game = games[index];
+        game.firstEngine = index % 2;
+
+        Board board(options.boardSize);
+        int player = playOpening(board, index / 2);
+
+        AI::SearchOptions search[ENGINE_COUNT];
+        for (int e = 0; e < ENGINE_COUNT; e++) {
+            seats[e].table->clear();
+            for (int p = 0; p < 2; p++) {
+                seats[e].players[p]->setSeed(options.seed + static_cast<std::uint32_t>(index) * 4u +
+                                             static_cast<std::uint32_t>(e * 2 + p));
+            }
+            search[e].timeBudget = options.engines[e].moveTime;
+            search[e].depthLimit = options.engines[e].depthLimit;
+        }
+
+        GameLogic::GameState state = GameLogic::checkGameState(board);
+        while (state == GameLogic::GameState::PLAYING) {
+            if (options.maxMoves > 0 && board.getMoveCount() >= options.maxMoves) {
+                state = GameLogic::GameState::DRAW;
+                break;
+            }
+
+            int engine = (player == 1) ? game.firstEngine : 1 - game.firstEngine;
+            AI& ai = *seats[engine].players[player - 1];
+            auto start = Clock::now();
+            AI::MoveEvaluation move = ai.findBestMove(board.getGrid(), search[engine]);
+            game.seconds[engine] += std::chrono::duration<double>(Clock::now() - start).count();
+            game.nodes[engine] += ai.getLastThinkingStats().nodesEvaluated;
+            game.moveCounts[engine]++;
+
+            if (move.row < 0 || !board.makeMove(move.row, move.col, player)) {
+                game.forfeitEngine = engine;
+                state = (player == 1) ? GameLogic::GameState::PLAYER2_WIN : GameLogic::GameState::PLAYER1_WIN;
+                break;
+            }
+            state = GameLogic::checkGameState(board, move.row, move.col);
+            player = (player == 1) ? 2 : 1;
+        }
+
+        game.result = state;
+        game.moves = board.getMoveHistory();
+    }
+
+    /**
+     * @brief options.openingPlies quân xen kẽ từ người 1 trong cửa sổ quanh tâm, không nước nào tạo 5
+     * @return Người sắp đi
+     */
+    int playOpening(Board& board, int opening) const {
+        std::mt19937 rng(options.seed ^ (static_cast<std::uint32_t>(opening) * 2654435761u));
+        const int origin = board.getSize() / 2 - OPENING_WINDOW / 2;
+        int player = 1;
+        while (board.getMoveCount() < options.openingPlies) {
+            int row = origin + static_cast<int>(rng() % OPENING_WINDOW);
+            int col = origin + static_cast<int>(rng() % OPENING_WINDOW);
+            if (!board.isValidMove(row, col) || board.makesFive(row, col, player)) continue;
+            board.makeMove(row, col, player);
+            player = (player == 1) ? 2 : 1;
+        }
+        return player;
+    }
+
+    void tally() {
+        for (EngineResult& result : results) {
+            result = EngineResult();
+        }
+        for (const Game& game : games) {
+            int winner = -1;
+            if (game.result == GameLogic::GameState::PLAYER1_WIN) winner = game.firstEngine;
+            else if (game.result == GameLogic::GameState::PLAYER2_WIN) winner = 1 - game.firstEngine;
+
+            for (int e = 0; e < ENGINE_COUNT; e++) {
+                EngineResult& r = results[e];
+                if (winner < 0) r.draws++;
+                else if (winner == e) r.wins++;
+                else r.losses++;
+                if (winner == e && game.firstEngine == e) r.winsAsFirst++;
+                if (game.forfeitEngine == e) r.forfeits++;
+                r.moves += game.moveCounts[e];
+                r.nodes += game.nodes[e];
+                r.seconds += game.seconds[e];
+            }
+        }
+    }
+
+    bool writeRecords() const {
+        if (options.recordPath.empty()) return true;
+        GameRecordWriter writer;
+        if (!writer.open(options.recordPath)) return false;
+        for (const Game& game : games) {
+            if (!writer.write(options.boardSize, game.moves, game.result)) return false;
+        }
+        writer.close();
+        return true;
+    }
+
+    /**
+     * @brief Chênh lệch Elo tương ứng với score (kẹp vào (0, 1) để không ra vô cực)
+     */
+    static double elo(double score) {
+        score = std::min(std::max(score, 0.001), 0.999);
+        return 400.0 * std::log10(score / (1.0 - score));
+    }
+
+    static std::string describe(const Engine& engine) {
+        std::ostringstream text;
+        text << "difficulty=" << static_cast<int>(engine.difficulty) << " style=" << styleName(engine.playStyle)
+             << " candidates=" << engine.maxCandidates << " depth=" << engine.depthLimit
+             << " ms=" << engine.moveTime.count() << " hash-mb=" << engine.hashMegabytes;
+        if (!engine.bookPath.empty()) text << " book=" << engine.bookPath;
+        return text.str();
+    }
+
+    static bool parseDifficulty(const std::string& value, AI::Difficulty& difficulty) {
+        if (value == "beginner") difficulty = AI::Difficulty::BEGINNER;
+        else if (value == "easy") difficulty = AI::Difficulty::EASY;
+        else if (value == "medium") difficulty = AI::Difficulty::MEDIUM;
+        else if (value == "hard") difficulty = AI::Difficulty::HARD;
+        else if (value == "expert") difficulty = AI::Difficulty::EXPERT;
+        else {
+            switch (std::atoi(value.c_str())) {
+                case 1: difficulty = AI::Difficulty::BEGINNER; break;
+                case 2: difficulty = AI::Difficulty::EASY; break;
+                case 4: difficulty = AI::Difficulty::MEDIUM; break;
+                case 6: difficulty = AI::Difficulty::HARD; break;
+                case 8: difficulty = AI::Difficulty::EXPERT; break;
+                default: return false;
+            }
+        }
+        return true;
+    }
+
+    static bool parseStyle(const std::string& value, AI::PlayStyle& style) {
+        if (value == "balanced") style = AI::PlayStyle::BALANCED;
+        else if (value == "aggressive") style = AI::PlayStyle::AGGRESSIVE;
+        else if (value == "defensive") style = AI::PlayStyle::DEFENSIVE;
+        else if (value == "positional") style = AI::PlayStyle::POSITIONAL;
+        else return false;
+        return true;
+    }
+
+    static const char* styleName(AI::PlayStyle style) {
+        switch (style) {
+            case AI::PlayStyle::AGGRESSIVE: return "aggressive";
+            case AI::PlayStyle::DEFENSIVE: return "defensive";
+            case AI::PlayStyle::POSITIONAL: return "positional";
+            default: return "balanced";
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    Tournament::Options options;
+    if (!Tournament::parseArguments(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--games N] [--workers N] [--size S] [--seed S]"
+                  << " [--opening-plies N] [--max-moves N] [--records FILE] [--a ENGINE] [--b ENGINE]\n"
+                  << "  ENGINE: name=X,difficulty=1|2|4|6|8|beginner..expert,"
+                  << "style=balanced|aggressive|defensive|positional,candidates=N,depth=N,ms=N,hash-mb=N,book=FILE"
+                  << std::endl;
+        return 2;
+    }
+
+    Tournament tournament(options);
+    std::string failedBook;
+    if (!tournament.loadBooks(failedBook)) {
+        std::cerr << "Cannot open opening book " << failedBook << std::endl;
+        return 1;
+    }
+    if (!tournament.run()) {
+        std::cerr << "Cannot write " << options.recordPath << std::endl;
+        return 1;
+    }
+    tournament.report(std::cout);
+    return 0;
+}
@@ -0,0 +1,149 @@
+// transposition.cpp - Transposition Table
+// Người 1: Logic & AI - Lưu kết quả search theo Zobrist hash để dùng lại giữa các nhánh
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class TranspositionTable
+ * @brief Fixed-size hash table of search results (score, depth, bound type, best move)
+ *
+ * Mỗi slot gồm 2 word 64 bit: data đóng gói kết quả và key ^ data. Khi đọc, slot chỉ
+ * hợp lệ nếu (key ^ data) khớp lại đúng key, nên một lần ghi dở dang bởi thread khác
+ * bị coi là miss thay vì trả về dữ liệu hỏng. Không cần lock; các thread có thể
+ * dùng chung một bảng, kể cả nhiều AI search cùng lúc (generation là atomic).
+ *
+ * Thay slot: luôn ghi đè nếu cùng key, slot thuộc lần search cũ, hoặc depth mới >= depth cũ.
+ */
+class TranspositionTable {
+public:
+    static const size_t DEFAULT_SIZE_MB = 16;
+    static const int NO_MOVE = 0xFFFF;
+
+    enum Bound : std::uint8_t {
+        BOUND_NONE = 0,
+        BOUND_EXACT = 1,     // Giá trị chính xác
+        BOUND_LOWER = 2,     // Fail-high: giá trị thật >= score
+        BOUND_UPPER = 3      // Fail-low: giá trị thật <= score
+    };
+
+    struct Entry {
+        int score;
+        int depth;
+        Bound bound;
+        int move;            // Chỉ số ô (row * MAX_SIZE + col) hoặc NO_MOVE
+
+        Entry() : score(0), depth(-1), bound(BOUND_NONE), move(NO_MOVE) {}
+    };
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB) : slotCount(0), generation(0) {
+        resize(megabytes);
+    }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Cấp phát lại bảng với kích thước megabytes (làm tròn xuống lũy thừa của 2 slot)
+     */
+    void resize(size_t megabytes) {
+        size_t bytes = (megabytes == 0 ? 1 : megabytes) * 1024 * 1024;
+        size_t count = 1;
+        while (count * 2 * sizeof(Slot) <= bytes) count *= 2;
+
+        slots.reset(new Slot[count]);
+        slotCount = count;
+        clear();
+    }
+
+    void clear() noexcept {
+        for (size_t i = 0; i < slotCount; i++) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+        generation.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gọi đầu mỗi lần search để slot của lần trước được ưu tiên thay thế
+     */
+    void newSearch() noexcept {
+        generation.store((generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK,
+                         std::memory_order_relaxed);
+    }
+
+    bool probe(std::uint64_t key, Entry& entry) const noexcept {
+        const Slot& slot = slots[key & (slotCount - 1)];
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) != key || unpackBound(data) == BOUND_NONE) {
+            return false;
+        }
+
+        entry.score = unpackScore(data);
+        entry.depth = unpackDepth(data);
+        entry.bound = unpackBound(data);
+        entry.move = unpackMove(data);
+        return true;
+    }
+
+    void store(std::uint64_t key, int score, int depth, Bound bound, int move) noexcept {
+        Slot& slot = slots[key & (slotCount - 1)];
+        std::uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t oldCheck = slot.check.load(std::memory_order_relaxed);
+
+        bool sameKey = (oldCheck ^ oldData) == key;
+        bool stale = unpackGeneration(oldData) != generation.load(std::memory_order_relaxed);
+        if (!sameKey && !stale && depth < unpackDepth(oldData)) {
+            return;
+        }
+
+        // Giữ lại best move cũ nếu lần ghi này không có
+        if (move == NO_MOVE && sameKey) {
+            move = unpackMove(oldData);
+        }
+
+        std::uint64_t data = pack(score, depth, bound, move);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    size_t getEntryCount() const noexcept { return slotCount; }
+    size_t getMemoryUsage() const noexcept { return slotCount * sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    static const unsigned GENERATION_MASK = 0x3F;
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slotCount;
+    std::atomic<unsigned> generation;
+
+    // data: [0..31] score | [32..39] depth | [40..41] bound | [42..57] move | [58..63] generation
+    std::uint64_t pack(int score, int depth, Bound bound, int move) const noexcept {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(score))
+             | (static_cast<std::uint64_t>(depth & 0xFF) << 32)
+             | (static_cast<std::uint64_t>(bound & 0x3) << 40)
+             | (static_cast<std::uint64_t>(move & 0xFFFF) << 42)
+             | (static_cast<std::uint64_t>(generation.load(std::memory_order_relaxed)) << 58);
+    }
+
+    static int unpackScore(std::uint64_t data) noexcept {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(data & 0xFFFFFFFFULL));
+    }
+    static int unpackDepth(std::uint64_t data) noexcept { return static_cast<int>((data >> 32) & 0xFF); }
+    static Bound unpackBound(std::uint64_t data) noexcept { return static_cast<Bound>((data >> 40) & 0x3); }
+    static int unpackMove(std::uint64_t data) noexcept { return static_cast<int>((data >> 42) & 0xFFFF); }
+    static unsigned unpackGeneration(std::uint64_t data) noexcept { return static_cast<unsigned>(data >> 58); }
+};
+
+#endif // TRANSPOSITION_H
@@ -0,0 +1,73 @@
+// zobrist.cpp - Zobrist Hashing Keys
+// Người 1: Logic & AI - Khóa ngẫu nhiên cố định cho hash vị trí (transposition table, opening book)
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class Zobrist
+ * @brief Fixed-seed random keys: one per (cell, player), one per board size, one for side to move
+ *
+ * Khóa được sinh bằng splitmix64 với seed cố định nên hash giống nhau giữa các lần
+ * chạy (cần cho opening book lưu ra file). Ô được đánh số theo row * MAX_CELLS + col
+ * nên khóa không phụ thuộc kích thước bàn cờ; kích thước được trộn vào qua sizeKey().
+ */
+class Zobrist {
+public:
+    static const int MAX_CELLS = 100;          // = Board::MAX_SIZE
+
+    static std::uint64_t piece(int row, int col, int player) noexcept {
+        return table().pieces[pieceIndex(row, col, player)];
+    }
+
+    /**
+     * @brief Bảng khóa quân phẳng, chỉ số pieceIndex(); để cập nhật nhiều khóa một lúc chỉ tra bảng một lần
+     */
+    static const std::uint64_t* pieces() noexcept {
+        return table().pieces.data();
+    }
+
+    static size_t pieceIndex(int row, int col, int player) noexcept {
+        return (static_cast<size_t>(row) * MAX_CELLS + col) * 2 + (player - 1);
+    }
+
+    static std::uint64_t sizeKey(int size) noexcept {
+        return table().sizes[size];
+    }
+
+    static std::uint64_t sideKey() noexcept {
+        return table().side;
+    }
+
+private:
+    struct Keys {
+        std::vector<std::uint64_t> pieces;
+        std::vector<std::uint64_t> sizes;
+        std::uint64_t side;
+
+        Keys() {
+            std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+            pieces.resize(static_cast<size_t>(MAX_CELLS) * MAX_CELLS * 2);
+            for (auto& key : pieces) key = next(state);
+            sizes.resize(MAX_CELLS + 1);
+            for (auto& key : sizes) key = next(state);
+            side = next(state);
+        }
+    };
+
+    static const Keys& table() {
+        static const Keys keys;
+        return keys;
+    }
+
+    static std::uint64_t next(std::uint64_t& state) noexcept {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // ZOBRIST_H